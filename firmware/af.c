@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// RDS alternative frequency (AF) following source file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [19th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Convert alternative frequencies into channels of the band - SriKIT contributors.
+// [18/10/2026] - Use the tuner interface - SriKIT contributors.
+// [18/10/2026] - Limit the muted time of the AF check - SriKIT contributors.
+// [19/10/2026] - Verify the PI code from the strongest alternative - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "include/stm8-util.h"
+
+#include "tuner.h"
+#include "rds.h"
+#include "af.h"
+
+// Position in the AF list to continue the checks from.
+unsigned char afNextPos = 0;
+
+static unsigned char afCheckPI(unsigned short pi)
+{
+    unsigned short rxPI;
+
+    // Receive RDS groups until the PI code of the new frequency is confirmed.
+    return (waitStationPI(&rxPI, AF_PI_TIMEOUT) && (rxPI == pi));
+}
+
+static unsigned char afTune(unsigned short channel)
+{
+    setTunerFrequency(channel);
+    waitReceiverTune(AF_TUNE_TIMEOUT);
+    tunerRefreshStatus();
+
+    return isStation() ? getRSSI() : 0;
+}
+
+unsigned char afFollow(unsigned char volLvl)
+{
+    unsigned short afChannel[RDS_AF_MAX];
+    unsigned char afLevel[RDS_AF_MAX];
+    unsigned short pi;
+    unsigned short originChannel;
+    unsigned short tunedChannel;
+    unsigned char originLevel;
+    unsigned char listCount;
+    unsigned char count;
+    unsigned char checked;
+    unsigned char pos;
+    unsigned char best;
+    unsigned short budget;
+
+    // Convert the frequencies into channels and drop the ones outside of the band.
+    listCount = rdsGetAFList(afChannel);
+    count = 0;
+    pos = 0;
+    while(pos < listCount)
+    {
+        afChannel[count] = getFrequencyChannel(afChannel[pos]);
+        if(afChannel[count] != 0xFFFF)
+        {
+            afLevel[count] = 0;
+            count++;
+        }
+
+        pos++;
+    }
+
+    if((count == 0) || (!rdsGetPI(&pi)))
+    {
+        // Station does not broadcast alternative frequencies.
+        return 0;
+    }
+
+    getTunerChannel(&originChannel);
+    tunedChannel = originChannel;
+    originLevel = getRSSI();
+
+    // Mute the audio output while checking the alternatives. Each step is
+    // charged with its timeout, and the return into the original frequency
+    // is reserved from the start.
+    setTunerVolume(0);
+    budget = AF_MUTE_BUDGET - AF_TUNE_TIMEOUT;
+
+    // Measure the signal level of the alternatives while the budget still
+    // covers one PI code check.
+    checked = 0;
+    while((checked < count) && (budget >= (AF_TUNE_TIMEOUT + AF_CHECK_TIME)))
+    {
+        pos = (afNextPos + checked) % count;
+        checked++;
+
+        if(afChannel[pos] != originChannel)
+        {
+            budget -= AF_TUNE_TIMEOUT;
+            afLevel[pos] = afTune(afChannel[pos]);
+            tunedChannel = afChannel[pos];
+        }
+    }
+
+    // Measure the rest of the alternatives in the next AF check.
+    afNextPos = (afNextPos + checked) % count;
+
+    // Verify the PI code from the strongest alternative, which is clearly
+    // stronger than the current frequency, until the budget runs out.
+    while(1)
+    {
+        best = 0xFF;
+        pos = 0;
+        while(pos < count)
+        {
+            if((afLevel[pos] > (originLevel + AF_RSSI_HYSTERESIS)) && ((best == 0xFF) || (afLevel[pos] > afLevel[best])))
+            {
+                best = pos;
+            }
+
+            pos++;
+        }
+
+        if((best == 0xFF) || (budget < ((afChannel[best] == tunedChannel) ? AF_PI_TIME : AF_CHECK_TIME)))
+        {
+            // No usable alternative frequency left within the budget.
+            break;
+        }
+
+        afLevel[best] = 0;
+        if(afChannel[best] != tunedChannel)
+        {
+            budget -= AF_TUNE_TIMEOUT;
+            afTune(afChannel[best]);
+            tunedChannel = afChannel[best];
+        }
+
+        budget -= AF_PI_TIME;
+        if(afCheckPI(pi))
+        {
+            // Same program is available in the alternative frequency.
+            afNextPos = 0;
+            setTunerVolume(volLvl);
+            return 1;
+        }
+    }
+
+    // Return to the original frequency.
+    afTune(originChannel);
+    setTunerVolume(volLvl);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// RDS alternative frequency (AF) following header file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [19th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Limit the muted time of the AF check - SriKIT contributors.
+// [18/10/2026] - Check the RDS dependency - SriKIT contributors.
+// [19/10/2026] - Verify the PI code from the strongest alternative - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#ifndef FM_MICRO_AF_HEADER
+#define FM_MICRO_AF_HEADER
+
+#ifndef RDA_RDS
+#error "RDS_AF requires RDA_RDS"
+#endif
+
+// Signal level (RSSI of 0BH) which starts the AF check, and the minimum
+// improvement to switch into an alternative frequency.
+#ifndef AF_RSSI_THRESHOLD
+#define AF_RSSI_THRESHOLD   24
+#endif
+
+#define AF_RSSI_HYSTERESIS  6
+
+// Tune timeout (in ms) and PI code verification timeout (in RDS_PI_POLL_TIME steps).
+#define AF_TUNE_TIMEOUT     100
+#define AF_PI_TIMEOUT       15
+
+#define AF_PI_TIME          (AF_PI_TIMEOUT * RDS_PI_POLL_TIME)
+
+// Time (in ms) to tune back into a measured alternative and verify its PI code.
+#define AF_CHECK_TIME       (AF_TUNE_TIMEOUT + AF_PI_TIME)
+
+// Longest time (in ms) the audio output is muted in one AF check, including
+// the return into the original frequency. The alternatives which cannot be
+// measured within this time are measured in the next AF check.
+#ifndef AF_MUTE_BUDGET
+#define AF_MUTE_BUDGET      1000
+#endif
+
+unsigned char afFollow(unsigned char volLvl);
+
+#endif /* FM_MICRO_AF_HEADER */
\ No newline at end of file
@@ -22,6 +22,7 @@
 //
 // Update log:
 // [05/10/2020] - Initial version - Dilshan Jayakody.
+// [19/10/2026] - Add interrupt state save and restore - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #ifndef STM8S103_INST_H
@@ -33,6 +34,11 @@
 #define cli()   {__asm__("sim\n");}     // Disable interrupts.
 #define wfi()   {__asm__("wfi\n");}     // Wait for interrupt.
 
+// Save / restore the condition code register (interrupt mask) through a
+// global unsigned char variable.
+#define saveInterruptState(var)     {__asm__("push cc\npop _" #var "\n");}
+#define restoreInterruptState(var)  {__asm__("push _" #var "\npop cc\n");}
+
 // CPU related instruction mappings.
 
 #define nop()   {__asm__("nop\n");}     // No operation.
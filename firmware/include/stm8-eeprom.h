@@ -20,6 +20,9 @@
 //
 // Update log:
 // [24/10/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Add word programming - SriKIT contributors.
+// [18/10/2026] - Add interrupt driven write queue - SriKIT contributors.
+// [18/10/2026] - Add block writes - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #ifndef HARDWARE_EEPROM_H
@@ -27,11 +30,33 @@
 
 #include "../include/stm8.h"
 
-void eepromWrite(unsigned short addr, unsigned char value);
+// Size of the EEPROM word, word programming requires word aligned address.
+#define EEPROM_WORD_SIZE    4
+
+// Number of pending writes (must be a power of 2).
+#ifndef EEPROM_QUEUE_SIZE
+#define EEPROM_QUEUE_SIZE   4
+#endif
 
-static inline unsigned char eepromRead(unsigned short addr)
+// Pending byte (length 1) or word (length EEPROM_WORD_SIZE) write.
+typedef struct EEPROMWrite
 {
-    return GLOBAL_MEM(addr);
-}
+    unsigned short addr;
+    unsigned char data[EEPROM_WORD_SIZE];
+    unsigned char length;
+} EEPROMWrite;
+
+// Writes are queued and programmed in the background (FLASH_IRQ), the calls
+// block only if the queue is full. eepromRead returns the pending values.
+void eepromWrite(unsigned short addr, unsigned char value);
+void eepromWriteWord(unsigned short addr, const unsigned char *value);
+void eepromWriteShort(unsigned short addr, unsigned short value);
+void eepromWriteBlock(unsigned short addr, const unsigned char *value, unsigned char length);
+unsigned char eepromRead(unsigned short addr);
+
+// Wait until all the pending writes are programmed.
+void eepromFlush();
+
+void FLASH_event() __interrupt(FLASH_IRQ);
 
 #endif /* HARDWARE_EEPROM_H */
\ No newline at end of file
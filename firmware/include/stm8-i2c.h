@@ -1,5 +1,5 @@
 //-----------------------------------------------------------------------------
-// STM8S I2C library for standard mode communication.
+// STM8S I2C library for standard and fast mode communication.
 //
 // Copyright (C) 2020 SriKIT contributors.
 //
@@ -15,11 +15,17 @@
 //
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
-//  
+//
 // Last updated: Dilshan Jayakody [9th Oct 2020]
 //
 // Update log:
 // [09/10/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Add interrupt driven transaction queue - SriKIT contributors.
+// [18/10/2026] - Add fast mode and computed bus timing - SriKIT contributors.
+// [18/10/2026] - Add timeouts, bus recovery and error counters - SriKIT contributors.
+// [18/10/2026] - Add write then read (repeated start) transactions - SriKIT contributors.
+// [18/10/2026] - Add bus occupancy and transaction metering - SriKIT contributors.
+// [19/10/2026] - Add queue full error code - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #ifndef HARDWARE_I2C_H
@@ -27,14 +33,113 @@
 
 #include "../include/stm8.h"
 
+// Maximum number of queued transactions (must be a power of 2).
+#ifndef I2C_QUEUE_SIZE
+#define I2C_QUEUE_SIZE  4
+#endif
+
+// Timeout of the queued transactions in i2cTick() periods.
+#ifndef I2C_TIMEOUT_TICKS
+#define I2C_TIMEOUT_TICKS   3
+#endif
+
+// Maximum number of status register polls in the blocking primitives.
+#ifndef I2C_POLL_LIMIT
+#define I2C_POLL_LIMIT  2000
+#endif
+
+#define I2C_READ_FLAG   0x01
+
+// Error codes (also used as indexes of the error counters).
+#define I2C_ERR_NONE            0
+#define I2C_ERR_TIMEOUT         1
+#define I2C_ERR_NACK            2
+#define I2C_ERR_BUS             3
+#define I2C_ERR_ARBITRATION     4
+#define I2C_ERR_OVERRUN         5
+
+#define I2C_ERROR_TYPES         6
+
+// Transaction is not submitted because the queue is full (not counted).
+#define I2C_ERR_QUEUE           6
+
+enum I2CTransactionState
+{
+    tsIdle,
+    tsQueued,
+    tsActive,
+    tsDone,
+    tsError
+};
+
+// Transaction descriptor. The descriptor and its data buffers must stay valid
+// until the transaction reaches tsDone or tsError state. The callback (if any)
+// is invoked from the I2C interrupt context. If readLength is not zero, the
+// write phase is followed by a repeated start and a read from readAddress.
+typedef struct I2CTransaction
+{
+    unsigned char address;          // 8-bit slave address, I2C_READ_FLAG selects read.
+    unsigned char *buffer;
+    unsigned char length;
+    unsigned char readAddress;      // Write then read transactions only.
+    unsigned char *readBuffer;
+    unsigned char readLength;
+    volatile unsigned char state;   // I2CTransactionState.
+    unsigned char error;            // I2C_ERR_* code of the completed transaction.
+    void (*callback)(struct I2CTransaction *trans);
+} I2CTransaction;
+
 void i2cInit();
+void i2cRecoverBus();
 
-void i2cStart();
-void i2cStop();
+// Polled (blocking) bus primitives. Do not mix with the transaction queue
+// while a queued transaction is in progress.
+unsigned char i2cStart();
+unsigned char i2cStop();
 
-void i2cWriteAddr(unsigned char addr);
-void i2cWrite(unsigned char data);
+unsigned char i2cWriteAddr(unsigned char addr);
+unsigned char i2cWrite(unsigned char data);
 
 unsigned char i2cRead(unsigned char ack);
 
+// Interrupt driven transaction queue.
+unsigned char i2cSubmit(I2CTransaction *trans);
+void i2cWait(I2CTransaction *trans);
+
+// Must be called periodically (from a timer interrupt) to enforce timeouts.
+void i2cTick();
+
+// Error statistics.
+unsigned short i2cGetErrorCount(unsigned char errorType);
+unsigned short i2cGetRecoveryCount();
+
+#ifdef I2C_METER
+// Length of the metering window in i2cTick() periods.
+#ifndef I2C_METER_WINDOW
+#define I2C_METER_WINDOW    195
+#endif
+
+// Bus usage counters. The busy time is measured in microseconds with TIM1
+// and covers the whole transaction, from the start condition to the stop.
+typedef struct I2CMeter
+{
+    unsigned long transactions;
+    unsigned long bytes;
+    unsigned short nacks;
+    unsigned long busyTime;
+} I2CMeter;
+
+// Cumulative counters since reset and the counters of the last completed
+// window (both can also be read with a debugger over SWIM).
+I2CMeter *i2cGetMeterTotal();
+I2CMeter *i2cGetMeterWindow();
+#endif
+
+static inline unsigned char i2cIsPending(I2CTransaction *trans)
+{
+    return ((trans->state == tsQueued) || (trans->state == tsActive));
+}
+
+void I2C_event() __interrupt(IIC_IRQ);
+
 #endif /* HARDWARE_I2C_H */
\ No newline at end of file
@@ -21,6 +21,7 @@
 // Update log:
 // [07/10/2020] - Initial version - Dilshan Jayakody.
 // [12/10/2020] - Add inline delay option - Dilshan Jayakody.
+// [18/10/2026] - Add master clock frequency option - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #ifndef STM8S103_COMMON_UTIL_H
@@ -33,6 +34,11 @@
 #define F_CPU 2000000UL
 #endif
 
+// Master (peripheral) clock frequency, defaults to the CPU clock frequency.
+#ifndef F_MASTER
+#define F_MASTER F_CPU
+#endif
+
 static inline unsigned char bcdToDec(unsigned char bcd)
 {
     return (bcd >> 4) * 10 + (bcd & 0x0F);
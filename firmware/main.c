@@ -21,15 +21,60 @@
 //
 // Update log:
 // [26/12/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Read receiver status in the background - SriKIT contributors.
+// [18/10/2026] - Derive CPU clock from faster master clock - SriKIT contributors.
+// [18/10/2026] - Enforce I2C transaction timeouts - SriKIT contributors.
+// [18/10/2026] - Add GPIO2 (STC) interrupt option - SriKIT contributors.
+// [18/10/2026] - Use adaptive receiver status polling - SriKIT contributors.
+// [18/10/2026] - Display RDS station name - SriKIT contributors.
+// [18/10/2026] - Add RDS clock idle screen - SriKIT contributors.
+// [18/10/2026] - Add RDS alternative frequency following - SriKIT contributors.
+// [18/10/2026] - Add PI code aware presets - SriKIT contributors.
+// [18/10/2026] - Add full band scan into presets - SriKIT contributors.
+// [18/10/2026] - Add cached station map navigation - SriKIT contributors.
+// [18/10/2026] - Wait for STC instead of fixed tune delays - SriKIT contributors.
+// [18/10/2026] - Add signal meter mode - SriKIT contributors.
+// [18/10/2026] - Validate seek stops with GPIO2 option - SriKIT contributors.
+// [18/10/2026] - Add band and channel spacing selection - SriKIT contributors.
+// [18/10/2026] - Use the tuner interface - SriKIT contributors.
+// [18/10/2026] - Show receiver faults and check the receiver periodically - SriKIT contributors.
+// [18/10/2026] - Save volume and channel in the settings journal - SriKIT contributors.
+// [18/10/2026] - Program presets with EEPROM word writes - SriKIT contributors.
+// [18/10/2026] - Write EEPROM in the background - SriKIT contributors.
+// [18/10/2026] - Move receiver interrupt and band encoding into the tuner backend - SriKIT contributors.
+// [18/10/2026] - Try the known stations first in a time limited PI code search - SriKIT contributors.
+// [18/10/2026] - Merge the nearby stops of the auto scan and save the presets in one block - SriKIT contributors.
+// [18/10/2026] - Skip the band and spacing combinations beyond the tuner channel range - SriKIT contributors.
+// [18/10/2026] - Initialize the receiver fault state - SriKIT contributors.
+// [18/10/2026] - Describe the display timer prescaler for any master clock - SriKIT contributors.
+// [19/10/2026] - Add the station into the map once per completed seek/tune - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #include "include/stm8.h"
 #include "include/stm8-util.h"
 #include "include/stm8-eeprom.h"
+#include "include/stm8-i2c.h"
+
+#ifdef RDA_RDS
+#include "rds.h"
+#endif
+
+#ifdef RDS_CLOCK
+#include "rtc.h"
+#endif
+
+#ifdef RDS_AF
+#include "af.h"
+#endif
+
+#ifdef STATION_MAP
+#include "stationmap.h"
+#endif
 
 #include "main.h"
 #include "serialssd.h"
-#include "rda5807m.h"
+#include "settings.h"
+#include "tuner.h"
 
 #define CLEAR_SSD_DECIMAL   0x00
 #define SET_SSD_DECIMAL     0x80
@@ -40,10 +85,56 @@
 #define MAX_STATION_NUMBER  10
 #define MIN_STATION_NUMBER  1
 
-#define EEPROM_VOLUME_ADDRESS   (EEPROM_START_ADDR + 1)
-#define EEPROM_TUNE_CHANNEL_ADDRESS   (EEPROM_START_ADDR + 2)
 #define EEPROM_MEM_MANAGER_BASE   (EEPROM_START_ADDR + 4)
 
+// PI codes of the memory manager stations (0 = not available).
+#define EEPROM_PRESET_PI_BASE   (EEPROM_START_ADDR + 32)
+
+// Band (TunerBand) and channel spacing (TunerSpacing) with the valid flag.
+#define EEPROM_BAND_ADDRESS     (EEPROM_START_ADDR + 26)
+#define BAND_CONFIG_VALID       0x80
+
+#define BAND_CONFIG(band, spacing)      (((band) << 2) | (spacing))
+#define BAND_CONFIG_BAND(config)        (((config) >> 2) & 0x03)
+#define BAND_CONFIG_SPACING(config)     ((config) & 0x03)
+
+// Master clock prescaler (HSIDIV) for 16MHz HSI oscillator.
+#if (F_MASTER == 16000000UL)
+#define CLK_HSI_DIVIDER     0x00
+#elif (F_MASTER == 8000000UL)
+#define CLK_HSI_DIVIDER     0x08
+#elif (F_MASTER == 4000000UL)
+#define CLK_HSI_DIVIDER     0x10
+#elif (F_MASTER == 2000000UL)
+#define CLK_HSI_DIVIDER     0x18
+#else
+#error "F_MASTER must be 16MHz, 8MHz, 4MHz or 2MHz"
+#endif
+
+// CPU clock prescaler (CPUDIV) and display timer prescaler. Timer 2 runs from the
+// master clock, so its prescaler compensates the master clock frequency.
+#if (F_MASTER == F_CPU)
+#define CLK_CPU_DIVIDER     0x00
+#elif (F_MASTER == (F_CPU * 2))
+#define CLK_CPU_DIVIDER     0x01
+#elif (F_MASTER == (F_CPU * 4))
+#define CLK_CPU_DIVIDER     0x02
+#elif (F_MASTER == (F_CPU * 8))
+#define CLK_CPU_DIVIDER     0x03
+#else
+#error "F_MASTER must be 1, 2, 4 or 8 times of F_CPU"
+#endif
+
+#if (F_MASTER == 16000000UL)
+#define DISPLAY_TIMER_PRESCALER 11
+#elif (F_MASTER == 8000000UL)
+#define DISPLAY_TIMER_PRESCALER 10
+#elif (F_MASTER == 4000000UL)
+#define DISPLAY_TIMER_PRESCALER 9
+#else
+#define DISPLAY_TIMER_PRESCALER 8
+#endif
+
 void TIM2_update() __interrupt(TIMER2_TRIGGER_IRQ)
 {
     // Set value of the first digit.
@@ -73,6 +164,15 @@ void TIM2_update() __interrupt(TIMER2_TRIGGER_IRQ)
     // Shutdown all segments.
     PD_ODR &= 0xE1;
 
+    // Abort stalled I2C transactions and update receiver bus load counters.
+    i2cTick();
+    receiverTick();
+
+#ifdef RDS_CLOCK
+    // Advance the software clock.
+    rtcTick();
+#endif
+
     // Clear timer 2 interrupt flag.
     TIM2_SR1 &= ~TIM2_SR1_UIF;
 }
@@ -83,6 +183,7 @@ void main()
     unsigned short tunerChannel;
     unsigned char animCycle;
     unsigned char memoryManagerStation;
+    unsigned char bandConfig;
     
     cli();
 
@@ -93,17 +194,23 @@ void main()
     // Activate display control timer (Timer2).
     initDisplayTimer();
 
-    // Load last volume level from EEPROM.
-    volumeLevel = eepromRead(EEPROM_VOLUME_ADDRESS);
+    // Load last volume level and station from EEPROM.
+    settingsLoad(&volumeLevel, &tunerChannel);
     if(volumeLevel > MAX_VOLUME_LEVEL)
     {
         // Volume setting is invalid or first time load.
         volumeLevel = 0;
     }
 
-    // Load last saved station from EEPROM.
-    tunerChannel = getSavedTunerChannel();
-    if(tunerChannel > 0x3FF)
+    // Load band and channel spacing, or keep the build time default.
+    bandConfig = eepromRead(EEPROM_BAND_ADDRESS);
+    if((bandConfig & BAND_CONFIG_VALID) && isTunerBandSupported(BAND_CONFIG_BAND(bandConfig), BAND_CONFIG_SPACING(bandConfig)))
+    {
+        setTunerBand(BAND_CONFIG_BAND(bandConfig), BAND_CONFIG_SPACING(bandConfig));
+    }
+
+    // Check the last saved station against the selected band.
+    if(tunerChannel > getMaxTunerChannel())
     {
         // Tuner channel is invalid or first time load.
         tunerChannel = 0;
@@ -158,15 +265,75 @@ void main()
     displayValue[3] = 0xFF;
     delay_ms(100);
 
-    // Initialize RDA5807M receiver.
-    initRDAFMReceiver(volumeLevel, tunerChannel);
+    // Initialize the tuner (RDA5807M by default).
+    tunerFault = initTuner(volumeLevel, tunerChannel);
+
+#ifdef STATION_MAP
+    // Load the known stations from EEPROM.
+    stationMapLoad();
+#endif
+
+#ifdef PRESET_AUTO_SCAN
+    // Memory button is held at power up, scan the band into the presets.
+    if((PA_IDR & 0x08) == 0x00)
+    {
+        autoScanPresets();
+
+        // Set modeResetCounter to raise EEPROM save function.
+        modeResetCounter = 1;
+
+        // Wait for the release of the memory button.
+        while((PA_IDR & 0x08) == 0x00)
+        {
+            delay_ms(10);
+        }
+
+        delay_ms(60);
+    }
+#endif
+
+#ifdef BAND_SELECT
+    // DOWN button is held at power up, select the band and channel spacing.
+    if((PD_IDR & 0x40) == 0x00)
+    {
+        if(selectReceiverBand())
+        {
+            // Set modeResetCounter to raise EEPROM save function.
+            modeResetCounter = 1;
+        }
+
+        // Wait for the release of the memory button.
+        while((PA_IDR & 0x08) == 0x00)
+        {
+            delay_ms(10);
+        }
+
+        delay_ms(60);
+    }
+#endif
+
+#ifdef RSSI_METER
+    // UP button is held at power up, run the signal meter.
+    if((PD_IDR & 0x20) == 0x00)
+    {
+        rssiMeter();
+
+        // Wait for the release of the memory button.
+        while((PA_IDR & 0x08) == 0x00)
+        {
+            delay_ms(10);
+        }
+
+        delay_ms(60);
+    }
+#endif
 
     buttonState = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
     displayDecimal = SET_SSD_DECIMAL;
     memoryManagerStation = 1;
 
     // Get receiver information.
-    getReceiverConfig(RECEIVER_READ_CONFIG_LEN);
+    tunerRefreshStatus();
     getTunerFrequency(displayValue);
 
     // Main service loop.
@@ -179,10 +346,7 @@ void main()
             if(currentMode == mdVolume)
             {
                 // Save new volume level in EEPROM.
-                if(eepromRead(EEPROM_VOLUME_ADDRESS) != volumeLevel)
-                {
-                    eepromWrite(EEPROM_VOLUME_ADDRESS, volumeLevel);
-                }
+                settingsSaveVolume(volumeLevel);
             }
             
             // UP button press is detected.
@@ -192,7 +356,16 @@ void main()
             // Set modeResetCounter to raise EEPROM save function.
             modeResetCounter = 1;
 
+#ifdef STATION_MAP
+            // Jump into the next nearby known station, otherwise seek (the
+            // stations found by the seek are added into the map).
+            if(!stationMapJump(0))
+            {
+                seekChannel(0);
+            }
+#else
             seekChannel(0);
+#endif
         }
 
         // Check for DOWN button event.
@@ -202,10 +375,7 @@ void main()
             if(currentMode == mdVolume)
             {
                 // Save new volume level in EEPROM.
-                if(eepromRead(EEPROM_VOLUME_ADDRESS) != volumeLevel)
-                {
-                    eepromWrite(EEPROM_VOLUME_ADDRESS, volumeLevel);
-                }
+                settingsSaveVolume(volumeLevel);
             }
             
             // DOWN button press is detected.
@@ -215,7 +385,16 @@ void main()
             // Set modeResetCounter to raise EEPROM save function.
             modeResetCounter = 1;
 
+#ifdef STATION_MAP
+            // Jump into the next nearby known station, otherwise seek (the
+            // stations found by the seek are added into the map).
+            if(!stationMapJump(1))
+            {
+                seekChannel(1);
+            }
+#else
             seekChannel(1);
+#endif
         }
 
         // Check for volume UP button event.
@@ -228,12 +407,7 @@ void main()
                 modeResetCounter = 0;
                 getTunerChannel(&tunerChannel);
 
-                if(tunerChannel != getSavedTunerChannel())
-                {
-                    // Save channel into EEPROM.
-                    eepromWrite(EEPROM_TUNE_CHANNEL_ADDRESS, ((tunerChannel >> 8) & 0xFF));
-                    eepromWrite((EEPROM_TUNE_CHANNEL_ADDRESS + 1), (tunerChannel & 0xFF));
-                }
+                settingsSaveChannel(tunerChannel);
             }
             
             // Volume UP button press is detected.            
@@ -243,7 +417,7 @@ void main()
             modeResetCounter = 0;
 
             setVolumeOnDisplay();
-            setRDAVolume(volumeLevel);
+            setTunerVolume(volumeLevel);
         }
 
         // Check for volume DOWN button event.
@@ -256,12 +430,7 @@ void main()
                 modeResetCounter = 0;
                 getTunerChannel(&tunerChannel);
 
-                if(tunerChannel != getSavedTunerChannel())
-                {
-                    // Save channel into EEPROM.
-                    eepromWrite(EEPROM_TUNE_CHANNEL_ADDRESS, ((tunerChannel >> 8) & 0xFF));
-                    eepromWrite((EEPROM_TUNE_CHANNEL_ADDRESS + 1), (tunerChannel & 0xFF));
-                }
+                settingsSaveChannel(tunerChannel);
             }
             
             // Volume DOWN button press is detected.
@@ -271,7 +440,7 @@ void main()
             modeResetCounter = 0;        
 
             setVolumeOnDisplay();
-            setRDAVolume(volumeLevel);            
+            setTunerVolume(volumeLevel);            
         }
 
         // Check for memory manager button event.
@@ -284,20 +453,12 @@ void main()
                 modeResetCounter = 0;
                 getTunerChannel(&tunerChannel);
 
-                if(tunerChannel != getSavedTunerChannel())
-                {
-                    // Save channel into EEPROM.
-                    eepromWrite(EEPROM_TUNE_CHANNEL_ADDRESS, ((tunerChannel >> 8) & 0xFF));
-                    eepromWrite((EEPROM_TUNE_CHANNEL_ADDRESS + 1), (tunerChannel & 0xFF));
-                }
+                settingsSaveChannel(tunerChannel);
             }            
             else
             {
                 // Save any pending volume level changes.
-                if(eepromRead(EEPROM_VOLUME_ADDRESS) != volumeLevel)
-                {
-                    eepromWrite(EEPROM_VOLUME_ADDRESS, volumeLevel);
-                }
+                settingsSaveVolume(volumeLevel);
             }
             
             // Get current channel from the tuner.
@@ -309,7 +470,12 @@ void main()
             {
                 // Station has been recall by the memory manager.
                 setTunerFrequency(tunerChannel);
-                delay_ms(50);
+                waitReceiverTune(RECALL_TUNE_TIMEOUT);
+
+#ifdef RDS_PRESET_PI
+                // Check the station is still in the saved channel.
+                verifyPresetPI(memoryManagerStation, &tunerChannel);
+#endif
 
                 // Set modeResetCounter to raise EEPROM save function.
                 modeResetCounter = 1;
@@ -319,16 +485,52 @@ void main()
             lastCheckChannel = 0xFFFF;
 
             // Return to frequency mode.
-            getReceiverConfig(RECEIVER_READ_CONFIG_LEN);
+            tunerRefreshStatus();
             getTunerFrequency(displayValue);
             displayDecimal = SET_SSD_DECIMAL;
             currentMode = mdFreq;
         }
 
+#ifdef RDS_CLOCK
+        // Any button activity cancels the clock idle screen.
+        if(buttonState != ((PD_IDR & 0x60) | (PA_IDR & 0x0E)))
+        {
+            clockIdleCounter = 0;
+        }
+#endif
+
         buttonState = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
         
-        // Get current frequency and status data from the RDA receiver.
-        getReceiverConfig(RECEIVER_READ_CONFIG_LEN);
+        // Get current frequency and status data from the receiver. The read
+        // completes in the background and is published on the next pass.
+        tunerPollStatus();
+
+        // Seek is ended without finding a station, or seek/tune is timed out.
+        if((getTuneState() == tnFailed) || (getTuneState() == tnTimeout))
+        {
+            tuneFailCounter = TUNE_FAIL_TIME;
+        }
+
+#ifdef STATION_MAP
+        // Remember the stations found by seek and tune, once per completed seek/tune.
+        if((getTuneState() == tnDone) && isStation())
+        {
+            getTunerChannel(&tunerChannel);
+            stationMapAdd(tunerChannel);
+        }
+#endif
+
+        clearTuneState();
+
+        // Verify the receiver periodically and restore it after a reset.
+        if((++tunerCheckCounter) > TUNER_CHECK_TIME)
+        {
+            tunerCheckCounter = 0;
+            if(getTuneState() == tnIdle)
+            {
+                tunerFault = checkTuner();
+            }
+        }
 
         // Update stereo indicator.
         if(isStereoChannel())
@@ -353,6 +555,32 @@ void main()
             // Shutdown preset channel indicator because current channel is not a station.
             PC_ODR &= 0xBF;
         }
+
+#ifdef RDS_AF
+        // Check the alternative frequencies if the signal level stays low.
+        if(afRetryCounter > 0)
+        {
+            afRetryCounter--;
+        }
+        else if((currentMode == mdFreq) && (modeResetCounter == 0) && (getRSSI() < AF_RSSI_THRESHOLD))
+        {
+            if((++afLowCounter) > AF_LOW_TIME)
+            {
+                afLowCounter = 0;
+                afRetryCounter = AF_RETRY_TIME;
+
+                if(afFollow(volumeLevel))
+                {
+                    // Set modeResetCounter to raise EEPROM save function.
+                    modeResetCounter = 1;
+                }
+            }
+        }
+        else
+        {
+            afLowCounter = 0;
+        }
+#endif
                 
         // Reset mode counter.
         if(currentMode == mdVolume)
@@ -361,10 +589,7 @@ void main()
             if((++modeResetCounter) > MODE_RESET_TIME)
             {
                 // Save new volume level in EEPROM.
-                if(eepromRead(EEPROM_VOLUME_ADDRESS) != volumeLevel)
-                {
-                    eepromWrite(EEPROM_VOLUME_ADDRESS, volumeLevel);
-                }
+                settingsSaveVolume(volumeLevel);
                 
                 // Mode timeout reached and set system (display) mode to Frequency Mode.
                 modeResetCounter = 0;
@@ -375,7 +600,47 @@ void main()
         else
         {
             // System is in Frequency mode.            
-            getTunerFrequency(displayValue);
+            if(tunerFault != tfNone)
+            {
+                // Show receiver fault code.
+                displayValue[0] = 'E';
+                displayValue[1] = 'r';
+                displayValue[2] = 'r';
+                displayValue[3] = tunerFault;
+                displayDecimal = CLEAR_SSD_DECIMAL;
+            }
+            else if(tuneFailCounter > 0)
+            {
+                // Show failed seek/tune indicator.
+                tuneFailCounter--;
+                displayValue[0] = '-';
+                displayValue[1] = '-';
+                displayValue[2] = '-';
+                displayValue[3] = '-';
+                displayDecimal = CLEAR_SSD_DECIMAL;
+            }
+            else
+#ifdef RDA_RDS
+#ifdef RDS_CLOCK
+            if((modeResetCounter == 0) && ((++clockIdleCounter) > CLOCK_IDLE_TIME) && setClockOnDisplay())
+            {
+                // Clock idle screen is active.
+                clockIdleCounter = CLOCK_IDLE_TIME;
+            }
+            else
+#endif
+            if((modeResetCounter > 0) || (!setStationNameOnDisplay()))
+            {
+                // Station name is not available or channel is just changed.
+                getTunerFrequency(displayValue);
+                displayDecimal = SET_SSD_DECIMAL;
+            }
+#else
+            {
+                getTunerFrequency(displayValue);
+                displayDecimal = SET_SSD_DECIMAL;
+            }
+#endif
 
             // If channel is changed, check for save timeout.
             if(modeResetCounter > 0)
@@ -386,22 +651,26 @@ void main()
                     modeResetCounter = 0;
                     getTunerChannel(&tunerChannel);
 
-                    if(tunerChannel != getSavedTunerChannel())
-                    {
-                        // Save channel into EEPROM.
-                        eepromWrite(EEPROM_TUNE_CHANNEL_ADDRESS, ((tunerChannel >> 8) & 0xFF));
-                        eepromWrite((EEPROM_TUNE_CHANNEL_ADDRESS + 1), (tunerChannel & 0xFF));
-                    }
+                    settingsSaveChannel(tunerChannel);
+
+#ifdef STATION_MAP
+                    // Save the stations found since the last save.
+                    stationMapSave();
+#endif
                 }
             }
         } 
 
-        delay_cycle(190);           
+        // Loop pacing also covers the time previously spent on the status read.
+        delay_cycle(380);           
     }
 }
 
 void initSystem()
 {
+    // Run master clock at F_MASTER and CPU at F_CPU.
+    CLK_CKDIVR = CLK_HSI_DIVIDER | CLK_CPU_DIVIDER;
+
     // PC3 [OUT] : Serial data.
     // PC4 [OUT] : Latch data.
     // PC5 [OUT] : Serial clock.
@@ -436,12 +705,30 @@ void initSystem()
     modeResetCounter = 0;
     volumeLevel = 0;    
     lastCheckChannel = 0xFFFF;
+    tuneFailCounter = 0;
+    tunerCheckCounter = 0;
+    tunerFault = tfNone;
+
+#ifdef RDA_RDS
+    nameScrollStep = 0;
+    nameScrollCounter = 0;
+#endif
+
+#ifdef RDS_CLOCK
+    clockIdleCounter = 0;
+#endif
+
+#ifdef RDS_AF
+    afLowCounter = 0;
+    afRetryCounter = 0;
+#endif
 }
 
 void initDisplayTimer()
 {
-    // Set timer 2 prescaler to 256.
-    TIM2_PSCR = 8;
+    // Set timer 2 prescaler to 2^DISPLAY_TIMER_PRESCALER, timer clock is
+    // 7812.5Hz at any supported F_MASTER.
+    TIM2_PSCR = DISPLAY_TIMER_PRESCALER;
 
     // Set ARRH to get ms interrupt.
     TIM2_ARRH = 0x00;
@@ -461,16 +748,14 @@ void setVolumeOnDisplay()
     displayValue[3] = volumeLevel % 10;
 }
 
-unsigned short getSavedTunerChannel()
-{
-    return ((unsigned short)eepromRead(EEPROM_TUNE_CHANNEL_ADDRESS) << 8) | (eepromRead(EEPROM_TUNE_CHANNEL_ADDRESS + 1));
-}
-
 unsigned char memoryManager(unsigned char *stationNumber, unsigned short *channel)
 {   
     unsigned char buttonState;
     unsigned short memAddr;
     unsigned short idleCounter;
+#ifdef RDS_PRESET_PI
+    unsigned short stationPI;
+#endif
     
     // Display "S" for memory manager station.
     displayDecimal = CLEAR_SSD_DECIMAL;
@@ -503,9 +788,17 @@ unsigned char memoryManager(unsigned char *stationNumber, unsigned short *channe
         // Check for STORE button event.
         if(((PA_IDR & 0x02) == 0x02) && ((buttonState & 0x02) == 0x00))
         {
-            memAddr = EEPROM_MEM_MANAGER_BASE + ((*stationNumber) * 2);
-            eepromWrite(memAddr, (((*channel) >> 8) & 0xFF));
-            eepromWrite((memAddr + 1), ((*channel) & 0xFF));
+            savePresetChannel((*stationNumber), (*channel));
+
+#ifdef RDS_PRESET_PI
+            // Save PI code of the station (if available) to locate it after frequency changes.
+            if(!rdsGetPI(&stationPI))
+            {
+                stationPI = 0;
+            }
+
+            savePresetPI((*stationNumber), stationPI);
+#endif
             return 0;
         }
 
@@ -515,7 +808,7 @@ unsigned char memoryManager(unsigned char *stationNumber, unsigned short *channe
             memAddr = EEPROM_MEM_MANAGER_BASE + ((*stationNumber) * 2);
             (*channel) = ((unsigned short)eepromRead(memAddr) << 8) | (eepromRead(memAddr + 1));
 
-            if((*channel) > 0x3FF)
+            if((*channel) > getMaxTunerChannel())
             {
                 // Tuner channel is invalid or first time load.
                 (*channel) = 0;
@@ -541,8 +834,8 @@ unsigned char memoryManager(unsigned char *stationNumber, unsigned short *channe
 
         buttonState = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
 
-        // Get current frequency and status data from the RDA receiver.
-        getReceiverConfig(RECEIVER_READ_CONFIG_LEN);
+        // Get current frequency and status data from the receiver.
+        tunerPollStatus();
 
         // Update stereo indicator.
         if(isStereoChannel())
@@ -556,7 +849,8 @@ unsigned char memoryManager(unsigned char *stationNumber, unsigned short *channe
             PC_ODR &= 0x7F;
         }
 
-        delay_cycle(280); 
+        // Loop pacing also covers the time previously spent on the status read.
+        delay_cycle(470); 
     }
 }
 
@@ -599,4 +893,673 @@ void isPresetChannel(unsigned short *currentChannel)
             PC_ODR &= 0xBF;
         }        
     }
-}
\ No newline at end of file
+}
+
+#ifdef RDA_RDS
+
+unsigned char setStationNameOnDisplay()
+{
+    unsigned char nameLength = RDS_PS_LEN;
+    unsigned char offset = 0;
+    unsigned char pos = 0;
+
+    if((!isStation()) || (!rdsGetStationName(stationName)))
+    {
+        // Station name is not received yet.
+        nameScrollStep = 0;
+        nameScrollCounter = 0;
+        return 0;
+    }
+
+    // Skip trailing spaces of the name.
+    while((nameLength > 0) && (stationName[nameLength - 1] == ' '))
+    {
+        nameLength--;
+    }
+
+    if(nameLength == 0)
+    {
+        return 0;
+    }
+
+    // Scroll the names which do not fit into the display.
+    if((++nameScrollCounter) > NAME_SCROLL_TIME)
+    {
+        nameScrollCounter = 0;
+        nameScrollStep++;
+
+        if((nameLength <= 4) || (nameScrollStep > (nameLength - 4 + (NAME_SCROLL_HOLD * 2))))
+        {
+            nameScrollStep = 0;
+        }
+    }
+
+    if(nameScrollStep > NAME_SCROLL_HOLD)
+    {
+        offset = nameScrollStep - NAME_SCROLL_HOLD;
+        if(offset > (nameLength - 4))
+        {
+            offset = nameLength - 4;
+        }
+    }
+
+    while(pos < 4)
+    {
+        displayValue[pos] = ((offset + pos) < nameLength) ? stationName[offset + pos] : ' ';
+        pos++;
+    }
+
+    displayDecimal = CLEAR_SSD_DECIMAL;
+    return 1;
+}
+
+#endif
+
+#ifdef RDS_CLOCK
+
+unsigned char setClockOnDisplay()
+{
+    unsigned char hour;
+    unsigned char minute;
+
+    if(!rtcGetTime(&hour, &minute))
+    {
+        // Clock is not yet set by the RDS clock-time.
+        return 0;
+    }
+
+    // Show time in HHMM format (leading zero of the hour is blank).
+    displayValue[0] = hour / 10;
+    displayValue[1] = hour % 10;
+    displayValue[2] = minute / 10;
+    displayValue[3] = minute % 10;
+    displayDecimal = CLEAR_SSD_DECIMAL;
+
+    return 1;
+}
+
+#endif
+
+void savePresetChannel(unsigned char stationNumber, unsigned short channel)
+{
+    unsigned short memAddr = EEPROM_MEM_MANAGER_BASE + (stationNumber * 2);
+
+    // Write only the modified channel to reduce EEPROM wear, both bytes are in
+    // the same EEPROM word and programmed in one cycle.
+    if((((unsigned short)eepromRead(memAddr) << 8) | eepromRead(memAddr + 1)) != channel)
+    {
+        eepromWriteShort(memAddr, channel);
+    }
+}
+
+#ifdef RDS_PRESET_PI
+
+void savePresetPI(unsigned char stationNumber, unsigned short pi)
+{
+    unsigned short memAddr = EEPROM_PRESET_PI_BASE + (stationNumber * 2);
+
+    if((((unsigned short)eepromRead(memAddr) << 8) | eepromRead(memAddr + 1)) != pi)
+    {
+        eepromWriteShort(memAddr, pi);
+    }
+}
+
+void verifyPresetPI(unsigned char stationNumber, unsigned short *channel)
+{
+    unsigned short memAddr = EEPROM_PRESET_PI_BASE + (stationNumber * 2);
+    unsigned short savedPI = ((unsigned short)eepromRead(memAddr) << 8) | (eepromRead(memAddr + 1));
+    unsigned short stationPI;
+
+    if(savedPI == 0)
+    {
+        // PI code is not saved with this station.
+        return;
+    }
+
+    waitReceiverTune(PRESET_TUNE_TIMEOUT);
+    tunerRefreshStatus();
+
+    if(isStation())
+    {
+        if((!waitStationPI(&stationPI, PRESET_PI_TIMEOUT)) || (stationPI == savedPI))
+        {
+            // Same station, or station without (readable) RDS.
+            return;
+        }
+    }
+
+    // Station is moved, search for the same PI code in the band.
+    if(searchStationPI(savedPI, channel))
+    {
+        savePresetChannel(stationNumber, (*channel));
+
+        // Force preset indicator update.
+        lastCheckChannel = 0xFFFF;
+    }
+}
+
+unsigned char checkStationPI(unsigned short pi, unsigned short *budget)
+{
+    unsigned short stationPI;
+
+    // Only stations with RDS can be identified with the PI code.
+    if((!isStation()) || ((*budget) < PRESET_SEARCH_PI_TIME))
+    {
+        return 0;
+    }
+
+    (*budget) -= PRESET_SEARCH_PI_TIME;
+    return (waitStationPI(&stationPI, PRESET_SEARCH_PI_TIMEOUT) && (stationPI == pi));
+}
+
+unsigned char tuneStationPI(unsigned short pi, unsigned short channel, unsigned short *budget)
+{
+    (*budget) -= PRESET_TUNE_TIMEOUT;
+
+    setTunerFrequency(channel);
+    waitReceiverTune(PRESET_TUNE_TIMEOUT);
+    tunerRefreshStatus();
+
+    return checkStationPI(pi, budget);
+}
+
+unsigned char searchStationPI(unsigned short pi, unsigned short *channel)
+{
+    unsigned short lastChannel = (*channel);
+    unsigned short foundChannel;
+    unsigned short budget = PRESET_SEARCH_TIME;
+    unsigned char isWrapped = 0;
+#if defined(RDS_AF) || defined(STATION_MAP)
+    unsigned char pos;
+#endif
+#ifdef RDS_AF
+    unsigned short afList[RDS_AF_MAX];
+    unsigned char afCount;
+#endif
+
+    // Mute the audio output while searching.
+    setTunerVolume(0);
+
+#ifdef RDS_AF
+    // Try the alternative frequencies of the program first, when they are
+    // still known from an earlier reception.
+    afCount = rdsGetProgramAFList(pi, afList);
+    pos = 0;
+    while((pos < afCount) && (budget >= PRESET_TUNE_TIMEOUT))
+    {
+        foundChannel = getFrequencyChannel(afList[pos]);
+        pos++;
+
+        if((foundChannel != 0xFFFF) && (foundChannel != (*channel)) && tuneStationPI(pi, foundChannel, &budget))
+        {
+            (*channel) = foundChannel;
+            setTunerVolume(volumeLevel);
+            return 1;
+        }
+    }
+#endif
+
+#ifdef STATION_MAP
+    // Try the known stations before seeking through the band.
+    pos = 0;
+    while((budget >= PRESET_TUNE_TIMEOUT) && stationMapGet(pos, &foundChannel))
+    {
+        pos++;
+
+        if((foundChannel != (*channel)) && tuneStationPI(pi, foundChannel, &budget))
+        {
+            (*channel) = foundChannel;
+            setTunerVolume(volumeLevel);
+            return 1;
+        }
+    }
+#endif
+
+#if defined(RDS_AF) || defined(STATION_MAP)
+    // Start the seek from the saved channel.
+    setTunerFrequency(*channel);
+    waitReceiverTune(PRESET_TUNE_TIMEOUT);
+#endif
+
+    while(budget >= PRESET_SEEK_TIME)
+    {
+        // Seek to the next station and show its frequency as progress.
+        budget -= PRESET_SEEK_TIME;
+        if(!seekStation(1))
+        {
+            // There are no stations in the band.
+            break;
+        }
+
+        getTunerChannel(&foundChannel);
+        getTunerFrequency(displayValue);
+
+        // Stop after passing the starting point of the search.
+        if(foundChannel <= lastChannel)
+        {
+            isWrapped = 1;
+        }
+
+        if(isWrapped && (foundChannel >= (*channel)))
+        {
+            break;
+        }
+
+        lastChannel = foundChannel;
+
+        if(checkStationPI(pi, &budget))
+        {
+            (*channel) = foundChannel;
+            setTunerVolume(volumeLevel);
+            return 1;
+        }
+    }
+
+    // Station is not found, return into the saved channel.
+    setTunerFrequency(*channel);
+    setTunerVolume(volumeLevel);
+    return 0;
+}
+
+#endif
+
+#ifdef PRESET_AUTO_SCAN
+
+unsigned char rankScanStation(unsigned short *scanChannel, unsigned char *scanLevel, unsigned char stationCount, unsigned short channel, unsigned char level)
+{
+    unsigned char pos = 0xFF;
+
+#ifdef STATION_MAP
+    stationMapAdd(channel);
+#endif
+
+    // Keep the strongest stations ordered by the signal level.
+    if(stationCount < MAX_STATION_NUMBER)
+    {
+        pos = stationCount++;
+    }
+    else if(level > scanLevel[MAX_STATION_NUMBER - 1])
+    {
+        pos = MAX_STATION_NUMBER - 1;
+    }
+
+    if(pos != 0xFF)
+    {
+        while((pos > 0) && (scanLevel[pos - 1] < level))
+        {
+            scanChannel[pos] = scanChannel[pos - 1];
+            scanLevel[pos] = scanLevel[pos - 1];
+            pos--;
+        }
+
+        scanChannel[pos] = channel;
+        scanLevel[pos] = level;
+    }
+
+    return stationCount;
+}
+
+void autoScanPresets()
+{
+    unsigned short scanChannel[MAX_STATION_NUMBER];
+    unsigned char scanLevel[MAX_STATION_NUMBER];
+    unsigned char presetData[MAX_STATION_NUMBER * 2];
+    unsigned short foundChannel;
+    unsigned short lastChannel;
+    unsigned short stopChannel;
+    unsigned char stopLevel;
+    unsigned char foundLevel;
+    unsigned char mergeRange;
+    unsigned char stationCount = 0;
+    unsigned char isFound;
+    unsigned char isStopped = 0;
+    unsigned char pos;
+
+    // Mute the audio output and start from the lower end of the band.
+    setTunerVolume(0);
+    setTunerFrequency(0);
+    waitReceiverTune(SCAN_TUNE_TIMEOUT);
+    tunerRefreshStatus();
+    isFound = isStation();
+
+    mergeRange = SCAN_MERGE_RANGE / TUNER_SPACING_KHZ(getTunerSpacing());
+    lastChannel = 0;
+
+    while(1)
+    {
+        // Show the frequency of the scanner as progress.
+        getTunerChannel(&foundChannel);
+        getTunerFrequency(displayValue);
+
+        if(isFound)
+        {
+            foundLevel = getRSSI();
+
+            if(isStopped && ((foundChannel - lastChannel) <= mergeRange))
+            {
+                // Same station in the next channel, keep the strongest stop.
+                if(foundLevel > stopLevel)
+                {
+                    stopChannel = foundChannel;
+                    stopLevel = foundLevel;
+                }
+            }
+            else
+            {
+                if(isStopped)
+                {
+                    stationCount = rankScanStation(scanChannel, scanLevel, stationCount, stopChannel, stopLevel);
+                }
+
+                stopChannel = foundChannel;
+                stopLevel = foundLevel;
+                isStopped = 1;
+            }
+
+            lastChannel = foundChannel;
+        }
+
+        // Seek the next station until the end of the band.
+        if(!seekStation(1))
+        {
+            break;
+        }
+
+        getTunerChannel(&foundChannel);
+        if(foundChannel <= lastChannel)
+        {
+            // Seek is wrapped into the beginning of the band.
+            break;
+        }
+
+        isFound = 1;
+    }
+
+    if(isStopped)
+    {
+        stationCount = rankScanStation(scanChannel, scanLevel, stationCount, stopChannel, stopLevel);
+    }
+
+    // Save all the presets in one block (strongest station in the first slot),
+    // each EEPROM word is programmed once.
+    pos = 0;
+    while(pos < MAX_STATION_NUMBER)
+    {
+        foundChannel = (pos < stationCount) ? scanChannel[pos] : 0;
+        presetData[pos * 2] = (foundChannel >> 8) & 0xFF;
+        presetData[(pos * 2) + 1] = foundChannel & 0xFF;
+        pos++;
+    }
+
+    eepromWriteBlock((EEPROM_MEM_MANAGER_BASE + (MIN_STATION_NUMBER * 2)), presetData, sizeof(presetData));
+
+#ifdef RDS_PRESET_PI
+    // PI codes of the new presets are saved when they are received.
+    pos = 0;
+    while(pos < sizeof(presetData))
+    {
+        presetData[pos] = 0;
+        pos++;
+    }
+
+    eepromWriteBlock((EEPROM_PRESET_PI_BASE + (MIN_STATION_NUMBER * 2)), presetData, sizeof(presetData));
+#endif
+
+#ifdef STATION_MAP
+    stationMapSave();
+#endif
+
+    // Tune into the strongest station.
+    setTunerFrequency(stationCount ? scanChannel[0] : 0);
+    setTunerVolume(volumeLevel);
+
+    // Display "S" with the number of stations found.
+    displayDecimal = CLEAR_SSD_DECIMAL;
+    displayValue[0] = 5;
+    displayValue[1] = 0xFF;
+    displayValue[2] = ((stationCount / 10) ? 1 : 0xFF);
+    displayValue[3] = stationCount % 10;
+    delay_ms(SCAN_RESULT_TIME);
+
+    lastCheckChannel = 0xFFFF;
+    displayDecimal = SET_SSD_DECIMAL;
+    tunerRefreshStatus();
+    getTunerFrequency(displayValue);
+}
+
+#endif
+
+#ifdef RSSI_METER
+
+void setMeterOnDisplay(unsigned char label, unsigned char level)
+{
+    // Show the label with the 3 digit RSSI value.
+    displayValue[0] = label;
+    displayValue[1] = (level / 100) ? (level / 100) : 0xFF;
+    displayValue[2] = (level / 10) ? ((level / 10) % 10) : 0xFF;
+    displayValue[3] = level % 10;
+}
+
+void rssiMeter()
+{
+    unsigned char meterView = mvAverage;
+    unsigned char meterButton;
+    unsigned char sampleCount = 0;
+    unsigned char level;
+    unsigned char levelMin = 0xFF;
+    unsigned char levelMax = 0;
+    unsigned short levelSum = 0;
+    unsigned char pos;
+
+    displayDecimal = CLEAR_SSD_DECIMAL;
+
+    // Wait for the release of the UP button.
+    while((PD_IDR & 0x20) == 0x00)
+    {
+        delay_ms(10);
+    }
+
+    meterButton = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
+
+    // Run until the memory button is pressed.
+    while(PA_IDR & 0x08)
+    {
+        // Sample the signal level at a fixed rate.
+        delay_ms(METER_SAMPLE_TIME);
+        tunerRefreshStatus();
+        level = getRSSI();
+
+        if(level < levelMin)
+        {
+            levelMin = level;
+        }
+
+        if(level > levelMax)
+        {
+            levelMax = level;
+        }
+
+        levelSum += level;
+
+        if(meterView == mvBar)
+        {
+            // Bar graph follows every sample, 2 steps per digit.
+            level = level / METER_BAR_STEP;
+            pos = 0;
+            while(pos < 4)
+            {
+                displayValue[pos] = (level > 1) ? '#' : ((level == 1) ? '|' : 0xFF);
+                level = (level > 2) ? (level - 2) : 0;
+                pos++;
+            }
+        }
+
+        if((++sampleCount) >= METER_WINDOW)
+        {
+            // Show the result of the window.
+            switch(meterView)
+            {
+            case mvAverage:
+                setMeterOnDisplay('A', (levelSum / METER_WINDOW));
+                break;
+            case mvMinimum:
+                setMeterOnDisplay('L', levelMin);
+                break;
+            case mvMaximum:
+                setMeterOnDisplay('H', levelMax);
+                break;
+            }
+
+            sampleCount = 0;
+            levelMin = 0xFF;
+            levelMax = 0;
+            levelSum = 0;
+        }
+
+        // UP / DOWN buttons seek the stations to align the antenna on.
+        if(((PD_IDR & 0x20) == 0x20) && ((meterButton & 0x20) == 0x00))
+        {
+            seekStation(0);
+        }
+        else if(((PD_IDR & 0x40) == 0x40) && ((meterButton & 0x40) == 0x00))
+        {
+            seekStation(1);
+        }
+        else if(((PA_IDR & 0x02) == 0x02) && ((meterButton & 0x02) == 0x00))
+        {
+            // VOL+ button selects the next view.
+            meterView = ((meterView + 1) < mvCount) ? (meterView + 1) : mvAverage;
+        }
+        else if(((PA_IDR & 0x04) == 0x04) && ((meterButton & 0x04) == 0x00))
+        {
+            // VOL- button selects the previous view.
+            meterView = (meterView > mvAverage) ? (meterView - 1) : (mvCount - 1);
+        }
+
+        meterButton = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
+    }
+
+    lastCheckChannel = 0xFFFF;
+    displayDecimal = SET_SSD_DECIMAL;
+    tunerRefreshStatus();
+    getTunerFrequency(displayValue);
+}
+
+#endif
+
+#ifdef BAND_SELECT
+
+void setBandOnDisplay(unsigned char band, unsigned char spacing)
+{
+    unsigned char spacingKHz = TUNER_SPACING_KHZ(spacing);
+
+    // Show "b" with the band number and the spacing (25, 50, 10 or 20 for
+    // 25kHz, 50kHz, 100kHz and 200kHz).
+    displayValue[0] = 'b';
+    displayValue[1] = band;
+    displayValue[2] = ((spacingKHz >= 100) ? (spacingKHz / 100) : (spacingKHz / 10));
+    displayValue[3] = ((spacingKHz >= 100) ? 0 : (spacingKHz % 10));
+}
+
+unsigned char selectReceiverBand()
+{
+    unsigned char band = getTunerBand();
+    unsigned char spacing = getTunerSpacing();
+    unsigned char selectButton;
+    unsigned char isSpacingDown = 0;
+    unsigned char pos;
+
+    displayDecimal = CLEAR_SSD_DECIMAL;
+    setBandOnDisplay(band, spacing);
+
+    // Wait for the release of the DOWN button.
+    while((PD_IDR & 0x40) == 0x00)
+    {
+        delay_ms(10);
+    }
+
+    selectButton = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
+
+    // Run until the memory button is pressed.
+    while(PA_IDR & 0x08)
+    {
+        delay_ms(10);
+
+        if(((PD_IDR & 0x20) == 0x20) && ((selectButton & 0x20) == 0x00))
+        {
+            // UP button selects the next band.
+            band = ((band + 1) < bdCount) ? (band + 1) : 0;
+        }
+        else if(((PD_IDR & 0x40) == 0x40) && ((selectButton & 0x40) == 0x00))
+        {
+            // DOWN button selects the previous band.
+            band = (band > 0) ? (band - 1) : (bdCount - 1);
+        }
+        else if(((PA_IDR & 0x02) == 0x02) && ((selectButton & 0x02) == 0x00))
+        {
+            // VOL+ button selects the next channel spacing.
+            isSpacingDown = 0;
+            spacing = ((spacing + 1) < spCount) ? (spacing + 1) : 0;
+        }
+        else if(((PA_IDR & 0x04) == 0x04) && ((selectButton & 0x04) == 0x00))
+        {
+            // VOL- button selects the previous channel spacing.
+            isSpacingDown = 1;
+            spacing = (spacing > 0) ? (spacing - 1) : (spCount - 1);
+        }
+
+        // Skip the spacing which has more channels in the band than the
+        // tuner can address (25kHz spacing of the 76 - 108MHz band).
+        while(!isTunerBandSupported(band, spacing))
+        {
+            spacing = isSpacingDown ? ((spacing > 0) ? (spacing - 1) : (spCount - 1)) : (((spacing + 1) < spCount) ? (spacing + 1) : 0);
+        }
+
+        setBandOnDisplay(band, spacing);
+        selectButton = (PD_IDR & 0x60) | (PA_IDR & 0x0E);
+    }
+
+    displayDecimal = SET_SSD_DECIMAL;
+
+    if((band == getTunerBand()) && (spacing == getTunerSpacing()))
+    {
+        // Band and spacing are not changed.
+        tunerRefreshStatus();
+        getTunerFrequency(displayValue);
+        return 0;
+    }
+
+    eepromWrite(EEPROM_BAND_ADDRESS, (BAND_CONFIG(band, spacing) | BAND_CONFIG_VALID));
+
+    // Channel numbers of the presets and the station map belong to the old
+    // band and spacing.
+    pos = MIN_STATION_NUMBER;
+    while(pos <= MAX_STATION_NUMBER)
+    {
+        savePresetChannel(pos, 0);
+#ifdef RDS_PRESET_PI
+        savePresetPI(pos, 0);
+#endif
+        pos++;
+    }
+
+#ifdef STATION_MAP
+    stationMapClear();
+    stationMapSave();
+#endif
+
+    // Commit the band change before the receiver switches into the new band.
+    eepromFlush();
+
+    // Tune into the lower end of the new band.
+    setTunerBand(band, spacing);
+    setTunerFrequency(0);
+    waitReceiverTune(BAND_TUNE_TIMEOUT);
+
+    lastCheckChannel = 0xFFFF;
+    tunerRefreshStatus();
+    getTunerFrequency(displayValue);
+    return 1;
+}
+
+#endif
\ No newline at end of file
@@ -21,6 +21,21 @@
 //
 // Update log:
 // [26/12/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Add GPIO2 (STC) interrupt option - SriKIT contributors.
+// [18/10/2026] - Display RDS station name - SriKIT contributors.
+// [18/10/2026] - Add RDS clock idle screen - SriKIT contributors.
+// [18/10/2026] - Add RDS alternative frequency following - SriKIT contributors.
+// [18/10/2026] - Add PI code aware presets - SriKIT contributors.
+// [18/10/2026] - Add full band scan into presets - SriKIT contributors.
+// [18/10/2026] - Indicate failed seek/tune - SriKIT contributors.
+// [18/10/2026] - Add signal meter mode - SriKIT contributors.
+// [18/10/2026] - Add band and channel spacing selection - SriKIT contributors.
+// [18/10/2026] - Show receiver faults and check the receiver periodically - SriKIT contributors.
+// [18/10/2026] - Save volume and channel in the settings journal - SriKIT contributors.
+// [18/10/2026] - Move receiver interrupt into the tuner backend - SriKIT contributors.
+// [18/10/2026] - Try the known stations first in a time limited PI code search - SriKIT contributors.
+// [18/10/2026] - Merge the nearby stops of the auto scan and save the presets in one block - SriKIT contributors.
+// [18/10/2026] - Remove the duplicate band tune timeout - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #ifndef FM_MICRO_MAIN_HEADER
@@ -30,6 +45,111 @@
 #define TUNER_SAVE_TIME     1000
 #define MEM_MANAGER_IDLE_TIME   2000
 
+// Time (in main loop cycles) to show the failed seek/tune indicator, and the
+// time (in ms) to wait for the tune of a recalled station.
+#define TUNE_FAIL_TIME      500
+#define RECALL_TUNE_TIMEOUT 100
+
+// Receiver check interval (in main loop cycles).
+#define TUNER_CHECK_TIME    5000
+
+#ifdef RDA_RDS
+
+// Station name scroll step time (in main loop cycles) and the number of steps
+// to hold the name at the beginning and at the end.
+#define NAME_SCROLL_TIME    200
+#define NAME_SCROLL_HOLD    3
+
+unsigned char stationName[RDS_PS_LEN];
+unsigned char nameScrollStep;
+unsigned short nameScrollCounter;
+
+#endif
+
+#ifdef RDS_CLOCK
+
+// Time without button activity (in main loop cycles) to show the clock.
+#define CLOCK_IDLE_TIME     5000
+
+unsigned short clockIdleCounter;
+
+#endif
+
+#ifdef RDS_AF
+
+// Time (in main loop cycles) with low signal level to start the AF check, and
+// the minimum time between two AF checks.
+#define AF_LOW_TIME         500
+#define AF_RETRY_TIME       30000
+
+unsigned short afLowCounter;
+unsigned short afRetryCounter;
+
+#endif
+
+#ifdef RDS_PRESET_PI
+
+#ifndef RDA_RDS
+#error "RDS_PRESET_PI requires RDA_RDS"
+#endif
+
+// Tune timeout (in ms) and PI code wait (in RDS_PI_POLL_TIME steps) of the
+// preset verification and of each station checked in the PI code search.
+#define PRESET_TUNE_TIMEOUT     100
+#define PRESET_PI_TIMEOUT       25
+#define PRESET_SEARCH_PI_TIMEOUT    15
+
+#define PRESET_SEARCH_PI_TIME   (PRESET_SEARCH_PI_TIMEOUT * RDS_PI_POLL_TIME)
+
+// Longest time (in ms) of the muted PI code search, and the time charged
+// for each seek step of the search.
+#ifndef PRESET_SEARCH_TIME
+#define PRESET_SEARCH_TIME      4000
+#endif
+
+#define PRESET_SEEK_TIME        200
+
+#endif
+
+#ifdef PRESET_AUTO_SCAN
+
+// Tune timeout (in ms) and the time (in ms) to show the number of stations found.
+#define SCAN_TUNE_TIMEOUT   100
+#define SCAN_RESULT_TIME    1500
+
+// Stops closer than this (in kHz) to the previous stop are the same station
+// received in the neighbouring channels.
+#define SCAN_MERGE_RANGE    75
+
+#endif
+
+#ifdef RSSI_METER
+
+// RSSI sample interval (in ms) and the number of samples in one min/max/average window.
+#define METER_SAMPLE_TIME   5
+#define METER_WINDOW        32
+
+// RSSI represented by one step of the bar graph (8 steps over 4 digits).
+#define METER_BAR_STEP      8
+
+enum MeterView
+{
+    mvAverage,
+    mvMinimum,
+    mvMaximum,
+    mvBar,
+    mvCount
+};
+
+#endif
+
+#ifdef BAND_SELECT
+
+// Tune timeout (in ms) after the band change.
+#define BAND_TUNE_TIMEOUT   100
+
+#endif
+
 enum SystemMode
 {
     mdFreq,
@@ -42,13 +162,47 @@ unsigned char displayDecimal;
 unsigned char volumeLevel;
 unsigned short modeResetCounter;
 unsigned short lastCheckChannel;
+unsigned short tuneFailCounter;
+unsigned short tunerCheckCounter;
+unsigned char tunerFault;
 enum SystemMode currentMode;
 
 void initSystem();
 void initDisplayTimer();
 void setVolumeOnDisplay();
-unsigned short getSavedTunerChannel();
 unsigned char memoryManager(unsigned char *stationNumber, unsigned short *channel);
 void isPresetChannel(unsigned short *currentChannel);
+void savePresetChannel(unsigned char stationNumber, unsigned short channel);
+
+#ifdef RDA_RDS
+unsigned char setStationNameOnDisplay();
+#endif
+
+#ifdef RDS_CLOCK
+unsigned char setClockOnDisplay();
+#endif
+
+#ifdef RDS_PRESET_PI
+void savePresetPI(unsigned char stationNumber, unsigned short pi);
+void verifyPresetPI(unsigned char stationNumber, unsigned short *channel);
+unsigned char checkStationPI(unsigned short pi, unsigned short *budget);
+unsigned char tuneStationPI(unsigned short pi, unsigned short channel, unsigned short *budget);
+unsigned char searchStationPI(unsigned short pi, unsigned short *channel);
+#endif
+
+#ifdef PRESET_AUTO_SCAN
+unsigned char rankScanStation(unsigned short *scanChannel, unsigned char *scanLevel, unsigned char stationCount, unsigned short channel, unsigned char level);
+void autoScanPresets();
+#endif
+
+#ifdef BAND_SELECT
+void setBandOnDisplay(unsigned char band, unsigned char spacing);
+unsigned char selectReceiverBand();
+#endif
+
+#ifdef RSSI_METER
+void rssiMeter();
+void setMeterOnDisplay(unsigned char label, unsigned char level);
+#endif
 
 #endif /* FM_MICRO_MAIN_HEADER */
\ No newline at end of file
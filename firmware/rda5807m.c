@@ -22,23 +22,76 @@
 //
 // Update log:
 // [26/12/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Use interrupt driven I2C transactions - SriKIT contributors.
+// [18/10/2026] - Report I2C errors to the caller - SriKIT contributors.
+// [18/10/2026] - Write only modified registers - SriKIT contributors.
+// [18/10/2026] - Split status read request and collection - SriKIT contributors.
+// [18/10/2026] - Add adaptive status polling - SriKIT contributors.
+// [18/10/2026] - Combine register update and status read - SriKIT contributors.
+// [18/10/2026] - Add RDS block reception - SriKIT contributors.
+// [18/10/2026] - Add signal level and blocking tune wait - SriKIT contributors.
+// [18/10/2026] - Add PI code wait and seek fail status - SriKIT contributors.
+// [18/10/2026] - Add blocking station seek - SriKIT contributors.
+// [18/10/2026] - Add tune complete status - SriKIT contributors.
+// [18/10/2026] - Track seek/tune completion, failure and timeout - SriKIT contributors.
+// [18/10/2026] - Add adaptive seek threshold and stop validation - SriKIT contributors.
+// [18/10/2026] - Add band and channel spacing selection - SriKIT contributors.
+// [18/10/2026] - Division free and cached frequency display conversion - SriKIT contributors.
+// [18/10/2026] - Access registers through field descriptions - SriKIT contributors.
+// [18/10/2026] - Implement the tuner interface as the first backend - SriKIT contributors.
+// [18/10/2026] - Verify receiver presence and configuration - SriKIT contributors.
+// [18/10/2026] - Handle GPIO2 interrupt and band selection in the backend - SriKIT contributors.
+// [18/10/2026] - Derive the seek threshold from the noise floor - SriKIT contributors.
+// [18/10/2026] - Update the status byte counters atomically - SriKIT contributors.
+// [18/10/2026] - Bound the blocking seek wait - SriKIT contributors.
+// [19/10/2026] - Configure the receiver when it appears after the start - SriKIT contributors.
+// [19/10/2026] - Report a full transaction queue in the register update - SriKIT contributors.
+// [19/10/2026] - Keep the last fault while the I2C queue is full - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #include "include/stm8-i2c.h"
 #include "include/stm8-util.h"
+#include "tuner.h"
 #include "rda5807m.h"
 
+#ifdef RDA_RDS
+#include "rds.h"
+#endif
+
 #define RDA5807M_WRITE_ADDRESS 0x20
 #define RDA5807M_READ_ADDRESS 0x21
 
-#define TUNE_SEEK_DOWN  0x00
-#define TUNE_SEEK_UP    0x02
+// Random access (register indexed) address.
+#define RDA5807M_RANDOM_ADDRESS 0x22
+
+#define FIRST_WRITE_REGISTER    0x02
+
+// Chip ID (high byte of 00H).
+#define CHIP_ID_REGISTER        0x00
+#define RDA5807M_CHIP_ID        0x58
 
-#define SEEK_CHANNEL    0x01
-#define TUNE_RECEIVER   0x10
+// Flag register which holds the specified rdaWriteReg byte as modified.
+#define MARK_REG_DIRTY(pos)     (rdaDirtyRegs |= (1 << ((pos) >> 1)))
 
-#define MIN_FREQ        87000UL
-#define CHANNEL_SPACE   25
+// Write a field of the shadow registers. SET_REG_FIELD always flags the
+// register to be written, CHANGE_REG_FIELD only if the value is changed.
+#define SET_REG_FIELD(field, value)     \
+    do { PUT_FIELD_(rdaWriteReg, field, value); MARK_REG_DIRTY(FIELD_POS_(field)); } while(0)
+#define CHANGE_REG_FIELD(field, value)  \
+    setRegisterByte(FIELD_POS_(field), ((rdaWriteReg[FIELD_POS_(field)] & ~FIELD_MASK_(field)) | (((value) << FIELD_SHIFT_(field)) & FIELD_MASK_(field))))
+
+// Active seek with its direction (adaptive seek).
+#define SEEK_ACTIVE     0x80
+#define SEEK_MODE_UP    0x01
+
+// Bits of 02H - 05H which must read back as written (SEEK, SEEKUP, CHAN,
+// TUNE, SOFT_RESET and RDS_FIFO_CLR are not retained).
+const unsigned char rdaVerifyMask[RECEIVER_VERIFY_LEN] = {
+    0xFC, 0xFD,     // 02H
+    0x00, 0x2F,     // 03H
+    0xFB, 0xFF,     // 04H
+    0xFF, 0xFF      // 05H
+    };
 
 unsigned char rdaWriteReg[RECEIVER_WRITE_CONFIG_LEN] = {
     INIT_RX_REG_0, INIT_RX_REG_1,   // 02H : Write operation starts from this address.    
@@ -49,157 +102,927 @@ unsigned char rdaWriteReg[RECEIVER_WRITE_CONFIG_LEN] = {
     INIT_RX_REG_10, INIT_RX_REG_11  // 07H
     };
 
-unsigned char rdaReadReg[RECEIVER_READ_CONFIG_LEN] = {
+unsigned char rdaReadReg[RECEIVER_READ_FULL_LEN] = {
     0, 0,   // 0AH - RDSR | STC | SF | RDSS | BLK_E | ST | READCHAN | READCHAN
             //       READCHAN
     0, 0    // 0BH - RSSI | RSSI | RSSI | RSSI | RSSI | RSSI | RSSI | FM TRUE
             //       FM_READY | RSVD | RSVD | ABCD_E | BLERA | BLERA | BLERB | BLERB
+            // 0CH - 0FH : RDS blocks A, B, C and D (RDA_RDS only).
     };
 
-void initRDAFMReceiver(unsigned char volLvl, unsigned short channel)
+// Registers (bit 0 = 02H) of rdaWriteReg which are not yet written to the receiver.
+unsigned char rdaDirtyRegs = 0;
+
+// Set once startReceiver has written the full configuration, and the last
+// requested channel to restore with it.
+unsigned char rdaConfigured = 0;
+unsigned short rdaTuneChannel = 0;
+
+// Last reported receiver fault (TunerFault), kept while the bus is busy.
+unsigned char rdaFault = tfNone;
+
+// Register index byte followed by the register values for random access writes.
+unsigned char rdaRandomBuffer[RECEIVER_WRITE_CONFIG_LEN + 1];
+
+// I2C transactions of the receiver. Status reads are received into a private
+// buffer and copied into rdaReadReg once the transaction is complete.
+I2CTransaction rdaWriteTrans = {RDA5807M_WRITE_ADDRESS, 0, 0, RDA5807M_READ_ADDRESS, rdaReadReg, 0, tsIdle, I2C_ERR_NONE, 0};
+I2CTransaction rdaReadTrans = {RDA5807M_READ_ADDRESS, 0, 0, 0, 0, 0, tsIdle, I2C_ERR_NONE, 0};
+
+unsigned char rdaReadBuffer[RECEIVER_READ_FULL_LEN];
+
+// Status polling policy state and bus load counters.
+unsigned char rdaTunePending = 0;
+unsigned char rdaPollInterval = STATUS_POLL_SLOW;
+unsigned char rdaPollCounter = 0;
+unsigned short rdaStatusBytes = 0;
+unsigned short rdaStatusBytesPerSec = 0;
+unsigned char rdaStatusTicks = 0;
+
+// Seek/tune progress (TuneState) and its elapsed time in receiverTick periods.
+volatile unsigned char rdaTuneState = tnIdle;
+volatile unsigned short rdaTuneTicks = 0;
+
+// Selected channel spacing (TunerSpacing), band is the BAND field of 03H.
+unsigned char rdaSpacing = TUNER_SPACING;
+
+#ifdef TUNER_INT
+// Status read is requested by the GPIO2 interrupt, and the main loop cycles
+// since the last status read.
+volatile unsigned char rdaStatusPending = 0;
+unsigned short rdaSafetyCounter = 0;
+#endif
+
+#ifdef ADAPTIVE_SEEK
+// Active seek (SEEK_ACTIVE with the direction), remaining stop validation
+// reads, skipped false stops, correction of SEEKTH on top of the noise floor
+// based threshold and the noise floor (RSSI * 8).
+unsigned char rdaSeekMode = 0;
+unsigned char rdaSeekValidate = 0;
+unsigned char rdaSeekResumes = 0;
+signed char rdaSeekOffset = 0;
+unsigned short rdaNoiseFloor = (SEEK_NOISE_INIT * 8);
+#endif
+
+static void setTunePending();
+static void clearTunePending();
+static void checkTuneTimeout();
+
+#ifdef ADAPTIVE_SEEK
+static void processSeekStatus();
+#endif
+
+#if defined(ADAPTIVE_SEEK) && defined(TUNER_INT)
+static unsigned char isSeekValidating();
+#endif
+
+static void setRegisterByte(unsigned char pos, unsigned char value)
+{
+    // Update shadow register and flag it only if the value is changed.
+    if(rdaWriteReg[pos] != value)
+    {
+        rdaWriteReg[pos] = value;
+        MARK_REG_DIRTY(pos);
+    }
+}
+
+static void setTuneChannel(unsigned short channel)
+{
+    rdaTuneChannel = channel;
+
+    // Set CHAN and TUNE bits of 03H.
+    SET_REG_FIELD(FIELD_CHAN_HIGH, (channel >> 2));
+    PUT_FIELD(rdaWriteReg, FIELD_CHAN_LOW, channel);
+    PUT_FIELD(rdaWriteReg, FIELD_TUNE, 1);
+}
+
+static void clearTuneChannel()
+{
+    // Restore CHAN and TUNE bits in the shadow register (not written).
+    PUT_FIELD(rdaWriteReg, FIELD_CHAN_HIGH, 0);
+    PUT_FIELD(rdaWriteReg, FIELD_CHAN_LOW, 0);
+    PUT_FIELD(rdaWriteReg, FIELD_TUNE, 0);
+}
+
+static unsigned short getReadChannel()
+{
+    return ((unsigned short)GET_FIELD(rdaReadReg, FIELD_READCHAN_HIGH) << 8) | GET_FIELD(rdaReadReg, FIELD_READCHAN_LOW);
+}
+
+static unsigned char readReceiverRegisters(unsigned char reg, unsigned char *buffer, unsigned char length)
+{
+    I2CTransaction regTrans;
+
+    // Random access read from the specified register. Wait for any
+    // outstanding status read to keep the bus free.
+    i2cWait(&rdaReadTrans);
+
+    regTrans.address = RDA5807M_RANDOM_ADDRESS;
+    regTrans.buffer = &reg;
+    regTrans.length = 1;
+    regTrans.readAddress = RDA5807M_RANDOM_ADDRESS;
+    regTrans.readBuffer = buffer;
+    regTrans.readLength = length;
+    regTrans.callback = 0;
+
+    if(!i2cSubmit(&regTrans))
+    {
+        // Transaction queue is full.
+        return I2C_ERR_QUEUE;
+    }
+
+    i2cWait(&regTrans);
+
+    return regTrans.error;
+}
+
+static unsigned char getReceiverFault(unsigned char error)
+{
+    // Full transaction queue says nothing about the receiver, keep the last result.
+    return (error == I2C_ERR_QUEUE) ? rdaFault : tfNoResponse;
+}
+
+static unsigned char verifyReceiver()
+{
+    unsigned char regs[RECEIVER_VERIFY_LEN];
+    unsigned char pos = 0;
+    unsigned char error;
+
+    // Receiver must respond with the RDA5807M chip ID.
+    if((error = readReceiverRegisters(CHIP_ID_REGISTER, regs, 2)) != I2C_ERR_NONE)
+    {
+        return getReceiverFault(error);
+    }
+
+    if(regs[0] != RDA5807M_CHIP_ID)
+    {
+        return tfChipId;
+    }
+
+    if(!rdaConfigured)
+    {
+        // Configuration is never written (receiver was missing at the start).
+        return tfConfig;
+    }
+
+    // Read back the configuration registers and compare with the shadow.
+    if((error = readReceiverRegisters(FIRST_WRITE_REGISTER, regs, RECEIVER_VERIFY_LEN)) != I2C_ERR_NONE)
+    {
+        return getReceiverFault(error);
+    }
+
+    while(pos < RECEIVER_VERIFY_LEN)
+    {
+        if((regs[pos] ^ rdaWriteReg[pos]) & rdaVerifyMask[pos])
+        {
+            return tfConfig;
+        }
+
+        pos++;
+    }
+
+    return tfNone;
+}
+
+static unsigned char startReceiver()
+{
+    unsigned char fault = verifyReceiver();
+    unsigned char error;
+
+    if((fault == tfNoResponse) || (fault == tfChipId))
+    {
+        // Receiver is missing or not yet powered up.
+        return fault;
+    }
+
+    // Initialize RDA5807M receiver with all the configuration registers.
+    PUT_FIELD(rdaWriteReg, FIELD_SOFT_RESET, 1);
+    rdaDirtyRegs = RECEIVER_ALL_REGS;
+    error = updateReceiverConfig();
+    delay_ms(5);
+
+    // Clear reset flag (also in the shadow if the write is failed).
+    SET_REG_FIELD(FIELD_SOFT_RESET, 0);
+    if((error != I2C_ERR_NONE) || ((error = updateReceiverConfig()) != I2C_ERR_NONE))
+    {
+        // Receiver is lost (or the bus is busy) during the configuration.
+        return getReceiverFault(error);
+    }
+
+    // Confirm that the configuration is applied.
+    rdaConfigured = 1;
+    return verifyReceiver();
+}
+
+unsigned char initTuner(unsigned char volLvl, unsigned short channel)
 {   
+    unsigned char retry = 0;
+    unsigned char fault;
+
     // Initialize I2C interface of the MCU.
     i2cInit();
     delay_cycle(75);
 
+#ifdef TUNER_INT
+    // GPIO2 [IN] : Pulled-up input with falling edge interrupt (EXTI_CR1 is
+    // writable only with the interrupts disabled).
+    __critical
+    {
+        TUNER_INT_DDR &= ~TUNER_INT_PIN;
+        TUNER_INT_CR1 |= TUNER_INT_PIN;
+        TUNER_INT_CR2 |= TUNER_INT_PIN;
+        EXTI_CR1 = (EXTI_CR1 & ~TUNER_INT_SENSE_MASK) | TUNER_INT_SENSE_FALL;
+    }
+#endif
+
     // Setup RDA5807M regsiter values to initialize the controller.
     if(volLvl == 0)
     {
         // At level 0 mute the audio output.
-        rdaWriteReg[0] &= 0xBF;
+        PUT_FIELD(rdaWriteReg, FIELD_DMUTE, 0);
     }
     else
     {
         // Release the mute state of the audio output and set DAC gain.
-        rdaWriteReg[0] |= 0x40;
-        rdaWriteReg[7] &= 0xF0;
-        rdaWriteReg[7] |= ((volLvl - 1) & 0x0F);
+        PUT_FIELD(rdaWriteReg, FIELD_DMUTE, 1);
+        PUT_FIELD(rdaWriteReg, FIELD_VOLUME, (volLvl - 1));
     }
 
     // Tune receiver into the specified channel.
-    rdaWriteReg[2] = (channel >> 2);
-    rdaWriteReg[3] |= (((channel << 6) & 0xC0) | TUNE_RECEIVER); 
-
-    // Initialize RDA5807M receiver.
-    updateReceiverConfig(RECEIVER_WRITE_CONFIG_LEN);
-    delay_ms(5);
+    setTuneChannel(channel);
 
-    // Clear reset flag.
-    rdaWriteReg[1] &= 0xFD;
-    updateReceiverConfig(RECEIVER_WRITE_CONFIG_LEN);
+    // Retry with increasing delay to cover slow power up of the receiver.
+    while(((fault = startReceiver()) != tfNone) && (retry < RECEIVER_INIT_RETRY))
+    {
+        delay_ms(RECEIVER_RETRY_DELAY << retry);
+        retry++;
+    }
 
     // Relase tune flag and tune frequency.
-    rdaWriteReg[2] = 0;
-    rdaWriteReg[3] &= 0x2F;
+    clearTuneChannel();
+    rdaFault = fault;
+    return fault;
+}
+
+unsigned char checkTuner()
+{
+    unsigned short channel = rdaConfigured ? getReadChannel() : rdaTuneChannel;
+    unsigned char fault = verifyReceiver();
+
+    if(fault == tfConfig)
+    {
+        // Receiver is reset (such as by a brown-out) or was not configured
+        // at the start, restore the configuration and the last channel.
+        setTuneChannel(channel);
+        fault = startReceiver();
+        clearTuneChannel();
+        setTunePending();
+    }
+
+    rdaFault = fault;
+    return fault;
 }
 
 void setTunerFrequency(unsigned short channel)
 {    
-    // Clear seek bit to ensure the frequency tuning.
-    rdaWriteReg[0] &= 0xFE;
+    // Clear seek bit to ensure the frequency tuning (and stop active seek).
+    SET_REG_FIELD(FIELD_SEEK, 0);
 
     // Tune receiver into the specified channel.
-    rdaWriteReg[2] = (channel >> 2);
-    rdaWriteReg[3] |= (((channel << 6) & 0xC0) | TUNE_RECEIVER); 
+    setTuneChannel(channel);
 
-    updateReceiverConfig(4);
+    applyReceiverConfig();
+    setTunePending();
 
     // Clear receiver tune flag.
-    rdaWriteReg[2] = 0x00;
-    rdaWriteReg[3] &= 0x2F;
+    clearTuneChannel();
+}
+
+void getTunerChannel(unsigned short *channel)
+{
+    (*channel) = getReadChannel();
 }
 
-void getTunerFrequency(unsigned char *freq)
+void setTunerBand(unsigned char band, unsigned char spacing)
 {
-    // Extract channel data from the receive buffer.
-    unsigned long tunedFreq = ((rdaReadReg[0] << 8) | rdaReadReg [1]) & 0x3FF;
-    tunedFreq = ((tunedFreq * CHANNEL_SPACE) + MIN_FREQ) / 100;
+    // Band and spacing are applied with the next tune.
+    rdaSpacing = spacing;
+    CHANGE_REG_FIELD(FIELD_BAND, band);
+    CHANGE_REG_FIELD(FIELD_SPACE, RDA_SPACE_CODE(spacing));
+}
 
-    // Convert frequency into 4 digit number.
-    freq[0] = tunedFreq / 1000;
-    freq[1] = (tunedFreq % 1000) / 100;
-    freq[2] = (tunedFreq % 100) / 10;
-    freq[3] = tunedFreq % 10;
+unsigned char getTunerBand()
+{
+    return GET_FIELD(rdaWriteReg, FIELD_BAND);
 }
 
-void getTunerChannel(unsigned short *channel)
+unsigned char getTunerSpacing()
+{
+    return rdaSpacing;
+}
+
+unsigned short getTunerChannelLimit()
 {
-    (*channel) = ((rdaReadReg[0] << 8) | rdaReadReg [1]) & 0x3FF;
+    return MAX_TUNER_CHANNEL;
 }
 
 unsigned char isStation()
 {
-    return ((rdaReadReg[2]) & 0x01);
+    return TEST_FIELD(rdaReadReg, FIELD_FM_TRUE);
+}
+
+unsigned char getRSSI()
+{
+    return GET_FIELD(rdaReadReg, FIELD_RSSI);
+}
+
+unsigned char isTuneComplete()
+{
+    return TEST_FIELD(rdaReadReg, FIELD_STC);
+}
+
+#if defined(ADAPTIVE_SEEK) && defined(TUNER_INT)
+
+static unsigned char isSeekValidating()
+{
+    // Seek is stopped and the stop is being validated.
+    return (rdaSeekMode && TEST_FIELD(rdaReadReg, FIELD_STC));
+}
+
+#endif
+
+unsigned char isSeekFailed()
+{
+    return TEST_FIELD(rdaReadReg, FIELD_SF);
 }
 
 unsigned char isStereoChannel()
 {    
     // Get stereo status only from the FM stations.
-    return (((rdaReadReg[2]) & 0x01) && ((rdaReadReg[0]) & 0x04));
+    return (TEST_FIELD(rdaReadReg, FIELD_FM_TRUE) && TEST_FIELD(rdaReadReg, FIELD_ST));
 }
 
-void updateReceiverConfig(unsigned char length)
+static unsigned char flushReceiverConfig(unsigned char statusLength)
 {
-    unsigned char pos = 0;
+    unsigned char first = 0;
+    unsigned char last = RECEIVER_WRITE_REG_COUNT - 1;
+    unsigned char pos;
 
-    // Start update RDA5807M registers.    
-    i2cStart();
-    i2cWriteAddr(RDA5807M_WRITE_ADDRESS);
+    if(rdaDirtyRegs == 0)
+    {
+        // Receiver is already up to date.
+        return I2C_ERR_NONE;
+    }
 
-    // Send specified configuration bytes to the receiver.
-    while(pos < length)
+    // Find the range of registers which need to be written.
+    while(!(rdaDirtyRegs & (1 << first)))
     {
-        i2cWrite(rdaWriteReg[pos]);
-        pos++;
+        first++;
     }
 
-    i2cStop();
+    while(!(rdaDirtyRegs & (1 << last)))
+    {
+        last--;
+    }
+
+    if(first == 0)
+    {
+        // Sequential write from 02H is the cheapest option.
+        rdaWriteTrans.address = RDA5807M_WRITE_ADDRESS;
+        rdaWriteTrans.buffer = rdaWriteReg;
+        rdaWriteTrans.length = (last + 1) * 2;
+    }
+    else
+    {
+        // Random access write saves 2 bytes for each register skipped at 02H
+        // for the cost of 1 register index byte.
+        rdaRandomBuffer[0] = FIRST_WRITE_REGISTER + first;
+        pos = 0;
+
+        while(pos < ((last - first + 1) * 2))
+        {
+            rdaRandomBuffer[pos + 1] = rdaWriteReg[(first * 2) + pos];
+            pos++;
+        }
+
+        rdaWriteTrans.address = RDA5807M_RANDOM_ADDRESS;
+        rdaWriteTrans.buffer = rdaRandomBuffer;
+        rdaWriteTrans.length = pos + 1;
+    }
+
+    // Optionally read the status after a repeated start. Sequential read
+    // always starts from 0AH, so it can follow both write modes.
+    rdaWriteTrans.readLength = statusLength;
+
+    // Register updates are short and infrequent, so wait (in WFI) for the
+    // transfer to complete and report the result to the caller.
+    if(!i2cSubmit(&rdaWriteTrans))
+    {
+        // Transaction queue is full, keep the registers dirty.
+        return I2C_ERR_QUEUE;
+    }
+
+    i2cWait(&rdaWriteTrans);
+
+    if(rdaWriteTrans.error == I2C_ERR_NONE)
+    {
+        rdaDirtyRegs = 0;
+
+        if(statusLength)
+        {
+            // Status is received into rdaReadReg. Drop any background read
+            // issued before the update and restart the polling interval.
+            __critical
+            {
+                rdaStatusBytes += (statusLength + 1);
+            }
+
+            rdaPollCounter = 0;
+            if(rdaReadTrans.state == tsDone)
+            {
+                rdaReadTrans.state = tsIdle;
+            }
+        }
+    }
+
+    return rdaWriteTrans.error;
 }
 
-void getReceiverConfig(unsigned char length)
+unsigned char updateReceiverConfig()
+{
+    return flushReceiverConfig(0);
+}
+
+unsigned char applyReceiverConfig()
+{
+    return flushReceiverConfig(RECEIVER_READ_CONFIG_LEN);
+}
+
+static void publishReceiverStatus(unsigned char length)
 {
     unsigned char pos = 0;
-    
-    // Start update RDA5807M registers.    
-    i2cStart();
-    i2cWriteAddr(RDA5807M_READ_ADDRESS);
 
-    // Read specified number of bytes from RDA5807M registers.
-    while(pos < (length - 1))
+    // Update receiver status with received bytes.
+    while(pos < length)
     {
-        rdaReadReg[pos] = i2cRead(1);
+        rdaReadReg[pos] = rdaReadBuffer[pos];
         pos++;
     }
 
-    // Read last configuration byte with NACK.
-    rdaReadReg[pos] = i2cRead(0);
-    i2cStop();
+#ifdef ADAPTIVE_SEEK
+    if(rdaSeekMode && (length >= RECEIVER_READ_CONFIG_LEN))
+    {
+        // Seek progress is tracked together with the signal level.
+        processSeekStatus();
+    }
+    else
+#endif
+    if(rdaTunePending && TEST_FIELD(rdaReadReg, FIELD_STC))
+    {
+        // Seek/tune is completed (SF is set if the seek found no station).
+        // Fetch full status on the next cycle and drop back to the slow rate.
+        clearTunePending();
+        rdaTuneState = TEST_FIELD(rdaReadReg, FIELD_SF) ? tnFailed : tnDone;
+    }
+
+#ifdef RDA_RDS
+    // Pass the RDS blocks to the decoder once a new group is ready (groups
+    // received while seek/tune is in progress belong to no station).
+    if((length == RECEIVER_READ_RDS_LEN) && (!rdaTunePending) && TEST_FIELD(rdaReadReg, FIELD_RDSR))
+    {
+        rdsProcessGroup(&rdaReadReg[RECEIVER_READ_CONFIG_LEN], GET_FIELD(rdaReadReg, FIELD_BLER));
+    }
+#endif
 }
 
+unsigned char getReceiverConfig(unsigned char length)
+{
+    // Wait for any outstanding status read and issue a fresh one.
+    i2cWait(&rdaReadTrans);
+
+    rdaReadTrans.buffer = rdaReadBuffer;
+    rdaReadTrans.length = length;
+    i2cSubmit(&rdaReadTrans);
+    i2cWait(&rdaReadTrans);
+
+    if(rdaReadTrans.state == tsDone)
+    {
+        publishReceiverStatus(length);
+    }
+
+    rdaReadTrans.state = tsIdle;
+    return rdaReadTrans.error;
+}
+
+void tunerRefreshStatus()
+{
+    getReceiverConfig(RECEIVER_READ_CONFIG_LEN);
+}
+
+unsigned char collectReceiverConfig()
+{
+    checkTuneTimeout();
+
+    if(rdaReadTrans.state != tsDone)
+    {
+        // No new status is received.
+        return 0;
+    }
+
+    // Publish the status received in the background.
+    publishReceiverStatus(rdaReadTrans.length);
+
+    rdaReadTrans.state = tsIdle;
+    return 1;
+}
+
+void requestReceiverConfig(unsigned char length)
+{
+    if(i2cIsPending(&rdaReadTrans))
+    {
+        // Status read is already in progress.
+        return;
+    }
+
+    // Queue the status read, result is available through collectReceiverConfig.
+    rdaReadTrans.buffer = rdaReadBuffer;
+    rdaReadTrans.length = length;
+
+    if(i2cSubmit(&rdaReadTrans))
+    {
+        // Account address and data bytes of the status read, the counter is
+        // also reset in receiverTick.
+        __critical
+        {
+            rdaStatusBytes += (length + 1);
+        }
+    }
+}
+
+static void setTunePending()
+{
+    // Poll short status at full loop speed until STC is set.
+    rdaTunePending = 1;
+    rdaPollInterval = STATUS_POLL_FAST;
+    rdaPollCounter = 0;
+
+    // Start the seek/tune timeout.
+    rdaTuneTicks = 0;
+    rdaTuneState = tnBusy;
+
+#ifdef ADAPTIVE_SEEK
+    // Plain tune, seek sets its mode after this.
+    rdaSeekMode = 0;
+#endif
+
+#ifdef RDA_RDS
+    // Drop the RDS data of the previous channel.
+    rdsReset();
+#endif
+}
+
+static void clearTunePending()
+{
+    rdaTunePending = 0;
+#ifdef ADAPTIVE_SEEK
+    rdaSeekMode = 0;
+#endif
+    rdaPollInterval = STATUS_POLL_SLOW;
+    rdaPollCounter = STATUS_POLL_SLOW;
+}
+
+static void checkTuneTimeout()
+{
+    if(rdaTunePending && (rdaTuneState == tnTimeout))
+    {
+        // Timeout is raised by receiverTick, stop the seek.
+        SET_REG_FIELD(FIELD_SEEK, 0);
+        updateReceiverConfig();
+        clearTunePending();
+    }
+}
+
+unsigned char getTuneState()
+{
+    return rdaTuneState;
+}
+
+void clearTuneState()
+{
+    // Acknowledge the result of the last seek/tune.
+    if(rdaTuneState != tnBusy)
+    {
+        rdaTuneState = tnIdle;
+    }
+}
+
+unsigned char waitReceiverTune(unsigned char timeout)
+{
+    // Poll short status until the seek/tune is over or the timeout (in ms)
+    // is reached. Result is available through getTuneState.
+    while(timeout && (rdaTuneState == tnBusy))
+    {
+        delay_ms(1);
+        getReceiverConfig(RECEIVER_READ_TUNE_LEN);
+        timeout--;
+    }
+
+    checkTuneTimeout();
+    return (rdaTuneState != tnBusy);
+}
+
+unsigned char seekStation(unsigned char isSeekUp)
+{
+    unsigned char waitCount = SEEK_WAIT_LIMIT;
+
+    // Start the seek and wait until it completes, fails or times out.
+    seekChannel(isSeekUp);
+    while(waitCount && (!waitReceiverTune(0xFF)))
+    {
+        waitCount--;
+    }
+
+    if(rdaTuneState == tnBusy)
+    {
+        // Seek is not finished within the wait limit, stop it.
+        rdaTuneState = tnTimeout;
+        checkTuneTimeout();
+    }
+
+    // Result is consumed here, so it is not reported as a failed user seek.
+    if(rdaTuneState != tnDone)
+    {
+        clearTuneState();
+        return 0;
+    }
+
+    // Fetch the channel and signal level of the station.
+    clearTuneState();
+    tunerRefreshStatus();
+    return 1;
+}
+
+#ifdef RDA_RDS
+
+unsigned char waitStationPI(unsigned short *pi, unsigned char timeout)
+{
+    // Receive RDS groups until the PI code is confirmed or the timeout (in
+    // RDS_PI_POLL_TIME steps) is reached.
+    while(timeout)
+    {
+        delay_ms(RDS_PI_POLL_TIME);
+        getReceiverConfig(RECEIVER_READ_RDS_LEN);
+
+        if(rdsGetPI(pi))
+        {
+            return 1;
+        }
+
+        timeout--;
+    }
+
+    return 0;
+}
+
+#endif
+
+#ifdef TUNER_INT
+
+unsigned char tunerPollStatus()
+{
+    unsigned char isUpdated = collectReceiverConfig();
+
+#ifdef ADAPTIVE_SEEK
+    // Seek stop is validated on the following status reads.
+    if(isSeekValidating())
+    {
+        rdaStatusPending = 1;
+    }
+#endif
+
+    if(rdaStatusPending || ((++rdaSafetyCounter) > STATUS_SAFETY_POLL_TIME))
+    {
+        // Read status on STC interrupt, or periodically as a safety net.
+        rdaStatusPending = 0;
+        rdaSafetyCounter = 0;
+        requestReceiverConfig(RECEIVER_READ_FULL_LEN);
+    }
+
+    return isUpdated;
+}
+
+void TUNER_interrupt() __interrupt(TUNER_INT_IRQ)
+{
+    // Seek/tune is completed (or RDS group is ready), fetch the receiver
+    // status in the main loop.
+    rdaStatusPending = 1;
+}
+
+#else
+
+unsigned char tunerPollStatus()
+{
+    unsigned char isUpdated = collectReceiverConfig();
+
+#ifdef RDA_RDS
+    if(!rdaTunePending)
+    {
+        // Poll RDS groups at the faster rate only on valid stations.
+        rdaPollInterval = isStation() ? STATUS_POLL_RDS : STATUS_POLL_SLOW;
+    }
+#endif
+
+    if((++rdaPollCounter) >= rdaPollInterval)
+    {
+        // Channel, STC and stereo flags are in 0AH, RSSI and FM_TRUE in 0BH
+        // and RDS blocks in 0CH - 0FH.
+        rdaPollCounter = 0;
+        requestReceiverConfig(rdaTunePending ? RECEIVER_READ_TUNE_LEN : RECEIVER_READ_FULL_LEN);
+    }
+
+    return isUpdated;
+}
+
+#endif
+
+void receiverTick()
+{
+    // Latch status read bus load once per second.
+    if((++rdaStatusTicks) >= RECEIVER_TICKS_PER_SEC)
+    {
+        rdaStatusTicks = 0;
+        __critical
+        {
+            rdaStatusBytesPerSec = rdaStatusBytes;
+            rdaStatusBytes = 0;
+        }
+    }
+
+    // Enforce the seek/tune timeout.
+    if((rdaTuneState == tnBusy) && ((++rdaTuneTicks) > TUNE_TIMEOUT_TICKS))
+    {
+        rdaTuneState = tnTimeout;
+    }
+}
+
+unsigned char getStatusPollInterval()
+{
+    return rdaPollInterval;
+}
+
+unsigned short getStatusBytesPerSec()
+{
+    unsigned short bytesPerSec;
+
+    // 16-bit value is updated in receiverTick (TIM2 interrupt).
+    __critical
+    {
+        bytesPerSec = rdaStatusBytesPerSec;
+    }
+
+    return bytesPerSec;
+}
+
+#ifdef ADAPTIVE_SEEK
+
+static signed char getSeekThreshold()
+{
+    // Noise floor (RSSI / 8) with the margin and the correction of the stops.
+    signed char threshold = (rdaNoiseFloor >> 6) + SEEKTH_MARGIN + rdaSeekOffset;
+
+    if(threshold < SEEKTH_MIN)
+    {
+        return SEEKTH_MIN;
+    }
+
+    return (threshold > SEEKTH_MAX) ? SEEKTH_MAX : threshold;
+}
+
+static void adjustSeekOffset(signed char step)
+{
+    // Keep the correction within the SEEKTH range.
+    if(((step > 0) && (getSeekThreshold() < SEEKTH_MAX)) || ((step < 0) && (getSeekThreshold() > SEEKTH_MIN)))
+    {
+        rdaSeekOffset += step;
+    }
+}
+
+static void startSeek()
+{
+    unsigned char seekMode = rdaSeekMode;
+
+    // Apply the adapted threshold with the SEEK and SEEKUP bits.
+    CHANGE_REG_FIELD(FIELD_SEEKTH, getSeekThreshold());
+    PUT_FIELD(rdaWriteReg, FIELD_SEEKUP, (seekMode & SEEK_MODE_UP));
+    SET_REG_FIELD(FIELD_SEEK, 1);
+    applyReceiverConfig();
+    setTunePending();
+
+    rdaSeekMode = seekMode;
+    rdaSeekValidate = SEEK_VALIDATE_SAMPLES;
+
+    // Restore seek and seek direction bits to defaults.
+    PUT_FIELD(rdaWriteReg, FIELD_SEEK, 0);
+    PUT_FIELD(rdaWriteReg, FIELD_SEEKUP, 0);
+}
+
+static void updateNoiseFloor(unsigned char rssi)
+{
+    // Moving average of the signal level on the channels without a station.
+    rdaNoiseFloor = rdaNoiseFloor - (rdaNoiseFloor >> 3) + rssi;
+}
+
+static void processSeekStatus()
+{
+    unsigned char rssi = getRSSI();
+
+    if(!TEST_FIELD(rdaReadReg, FIELD_STC))
+    {
+        // Seek is in progress, the channels passed over sample the noise floor.
+        if(!isStation())
+        {
+            updateNoiseFloor(rssi);
+        }
+
+        return;
+    }
+
+    if(TEST_FIELD(rdaReadReg, FIELD_SF))
+    {
+        // Band is searched without any stop, so the threshold is too high.
+        adjustSeekOffset(-1);
+
+        clearTunePending();
+        rdaTuneState = tnFailed;
+        return;
+    }
+
+    if(isStation() && (rssi >= ((rdaNoiseFloor >> 3) + SEEK_NOISE_MARGIN)))
+    {
+        // Stop holds a station, accept it once all validation reads agree.
+        // Valid stop halves the correction to return into the noise floor
+        // based threshold.
+        if((--rdaSeekValidate) == 0)
+        {
+            rdaSeekOffset /= 2;
+            clearTunePending();
+            rdaTuneState = tnDone;
+        }
+
+        return;
+    }
+
+    // False stop on noise or an image, raise the threshold and continue.
+    updateNoiseFloor(rssi);
+    adjustSeekOffset(1);
+
+    if((++rdaSeekResumes) > SEEK_RESUME_MAX)
+    {
+        clearTunePending();
+        rdaTuneState = tnFailed;
+        return;
+    }
+
+    startSeek();
+}
+
+void seekChannel(unsigned char isSeekUp)
+{
+    rdaSeekMode = SEEK_ACTIVE | (isSeekUp ? SEEK_MODE_UP : 0);
+    rdaSeekResumes = 0;
+    startSeek();
+}
+
+#else
+
 void seekChannel(unsigned char isSeekUp)
 {
     // Set SEEK and SEEKUP bits to start the channel search.
-    rdaWriteReg[0] |= (SEEK_CHANNEL | (isSeekUp ? TUNE_SEEK_UP : TUNE_SEEK_DOWN));
-    updateReceiverConfig(4);
+    PUT_FIELD(rdaWriteReg, FIELD_SEEKUP, (isSeekUp ? 1 : 0));
+    SET_REG_FIELD(FIELD_SEEK, 1);
+    applyReceiverConfig();
+    setTunePending();
 
     // Restore seek and seek direction bits to defaults.
-    rdaWriteReg[0] &= 0xFC;
+    PUT_FIELD(rdaWriteReg, FIELD_SEEK, 0);
+    PUT_FIELD(rdaWriteReg, FIELD_SEEKUP, 0);
 }
 
-void setRDAVolume(unsigned char volLvl)
+#endif
+
+void setTunerVolume(unsigned char volLvl)
 {
     if(volLvl == 0)
     {
         // At level 0 mute the audio output.
-        rdaWriteReg[0] &= 0xBF;
+        CHANGE_REG_FIELD(FIELD_DMUTE, 0);
     }
     else
     {
         // Release the mute state of the audio output and set DAC gain.
-        rdaWriteReg[0] |= 0x40;
-        rdaWriteReg[7] &= 0xF0;
-        rdaWriteReg[7] |= ((volLvl - 1) & 0x0F);
+        CHANGE_REG_FIELD(FIELD_DMUTE, 1);
+        CHANGE_REG_FIELD(FIELD_VOLUME, (volLvl - 1));
     }
     
-    updateReceiverConfig(8);
+    applyReceiverConfig();
 }
\ No newline at end of file
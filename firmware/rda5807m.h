@@ -22,6 +22,26 @@
 //
 // Update log:
 // [26/12/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Use interrupt driven I2C transactions - SriKIT contributors.
+// [18/10/2026] - Report I2C errors to the caller - SriKIT contributors.
+// [18/10/2026] - Write only modified registers - SriKIT contributors.
+// [18/10/2026] - Add GPIO2 (STC) interrupt option - SriKIT contributors.
+// [18/10/2026] - Add adaptive status polling - SriKIT contributors.
+// [18/10/2026] - Combine register update and status read - SriKIT contributors.
+// [18/10/2026] - Add RDS block reception - SriKIT contributors.
+// [18/10/2026] - Add signal level and blocking tune wait - SriKIT contributors.
+// [18/10/2026] - Add PI code wait and seek fail status - SriKIT contributors.
+// [18/10/2026] - Add blocking station seek - SriKIT contributors.
+// [18/10/2026] - Add tune complete status - SriKIT contributors.
+// [18/10/2026] - Track seek/tune completion, failure and timeout - SriKIT contributors.
+// [18/10/2026] - Add adaptive seek threshold and stop validation - SriKIT contributors.
+// [18/10/2026] - Add band and channel spacing selection - SriKIT contributors.
+// [18/10/2026] - Add register field descriptions - SriKIT contributors.
+// [18/10/2026] - Move common tuner interface into tuner.h - SriKIT contributors.
+// [18/10/2026] - Verify receiver presence and configuration - SriKIT contributors.
+// [18/10/2026] - Keep RDA5807M specifics out of the tuner interface - SriKIT contributors.
+// [18/10/2026] - Bound the blocking seek wait - SriKIT contributors.
+// [19/10/2026] - Keep the field clear mask in 8 bits - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #ifndef FM_MICRO_RDA5807M_HEADER
@@ -29,19 +49,121 @@
 
 #define RECEIVER_WRITE_CONFIG_LEN 12    // 02H - 08H
 #define RECEIVER_READ_CONFIG_LEN  4     // 0AH - 0BH
+#define RECEIVER_READ_STATUS_LEN  2     // 0AH
+#define RECEIVER_READ_RDS_LEN     12    // 0AH - 0FH
+
+// Length of the periodic status read (and size of the status buffers).
+#ifdef RDA_RDS
+#define RECEIVER_READ_FULL_LEN  RECEIVER_READ_RDS_LEN
+#else
+#define RECEIVER_READ_FULL_LEN  RECEIVER_READ_CONFIG_LEN
+#endif
+
+// Length of the status read while seek/tune is in progress. Adaptive seek
+// also needs RSSI and FM_TRUE (0BH) to track the noise floor.
+#ifdef ADAPTIVE_SEEK
+#define RECEIVER_READ_TUNE_LEN  RECEIVER_READ_CONFIG_LEN
+#else
+#define RECEIVER_READ_TUNE_LEN  RECEIVER_READ_STATUS_LEN
+#endif
+
+// Status polling intervals (in pollReceiverStatus calls) while seek/tune is
+// in progress and while the receiver is idle on a station.
+#define STATUS_POLL_FAST    1
+#define STATUS_POLL_SLOW    64
+
+// Status polling interval while RDS data is received (RDS group rate is
+// about 11.4 groups per second).
+#ifndef STATUS_POLL_RDS
+#define STATUS_POLL_RDS     16
+#endif
+
+// Seek/tune timeout (in receiverTick periods).
+#define TUNE_TIMEOUT_TICKS  (10 * RECEIVER_TICKS_PER_SEC)
+
+// Number of 255ms waits in the blocking seek (same 10s limit, independent
+// of receiverTick).
+#define SEEK_WAIT_LIMIT     40
+
+#ifdef ADAPTIVE_SEEK
+
+// Range of the adapted seek threshold (SEEKTH of 05H), and the margin of
+// SEEKTH above the noise floor (RSSI / 8 in the 4-bit SEEKTH scale).
+#define SEEKTH_MIN          4
+#define SEEKTH_MAX          15
+#define SEEKTH_MARGIN       7
+
+// Initial noise floor and the RSSI margin above the noise floor required to
+// accept a seek stop.
+#define SEEK_NOISE_INIT     12
+#define SEEK_NOISE_MARGIN   10
+
+// Status reads to validate a seek stop, and the maximum number of false
+// stops to skip in one seek.
+#define SEEK_VALIDATE_SAMPLES   8
+#define SEEK_RESUME_MAX         20
+
+#endif
+
+#ifdef TUNER_INT
+
+// Status read interval (in tunerPollStatus calls) used as a safety net for
+// the events which are not signaled through GPIO2 (such as stereo indicator).
+#define STATUS_SAFETY_POLL_TIME     250
+
+#endif
+
+// Configuration registers (02H - 05H) verified after the write.
+#define RECEIVER_VERIFY_LEN         8
+
+// Initialization retries and the delay (in ms) before the first retry, which
+// is doubled on each retry.
+#define RECEIVER_INIT_RETRY         4
+#define RECEIVER_RETRY_DELAY        20
+
+#define RECEIVER_WRITE_REG_COUNT    (RECEIVER_WRITE_CONFIG_LEN / 2)
+#define RECEIVER_ALL_REGS           0x3F
 
 #define MAX_RDA_OUTPUT_VOLUME   0x0F
 
+// Highest channel number of the 10-bit CHAN field.
+#define MAX_TUNER_CHANNEL   0x3FF
+
+// BAND of 03H is the TunerBand index, and SPACE of 03H (0 = 100kHz, 1 = 200kHz,
+// 2 = 50kHz and 3 = 25kHz) of a TunerSpacing is picked from 0x4B.
+#define RDA_SPACE_CODE(spacing)     ((0x4B >> ((spacing) << 1)) & 0x03)
+
 #define INIT_RX_REG_0	0xD0	// DHIZ | DMUTE | MONO | BASS | RCLK_MODE | RCLK | SEEKUP | SEEK
+#ifdef RDA_RDS
+#define INIT_RX_REG_1	0x0F	// SKMODE | CLK_MODE | CLK_MODE | CLK_MODE | RDS_EN | NEW_METHOD | SOFT_RESET | ENABLE
+#else
 #define INIT_RX_REG_1	0x07	// SKMODE | CLK_MODE | CLK_MODE | CLK_MODE | RDS_EN | NEW_METHOD | SOFT_RESET | ENABLE
+#endif
 
 #define INIT_RX_REG_2	0x00	// CHAN
-#define INIT_RX_REG_3	0x03	// CHAN | CHAN | DIRECT_MODE | TUNE | BAND | BAND | SPACE | SPACE
+#define INIT_RX_REG_3	((TUNER_BAND << 2) | RDA_SPACE_CODE(TUNER_SPACING))	// CHAN | CHAN | DIRECT_MODE | TUNE | BAND | BAND | SPACE | SPACE
+
+#ifdef TUNER_INT
+
+// GPIO2 generates 5ms low pulse on seek/tune complete (STCIEN = 1, GPIO2 = INT, INT_MODE = 0).
+#ifdef RDA_RDS
+// RDS group ready also generates the pulse (RDSIEN = 1).
+#define INIT_RX_REG_4	0xC4	// RDSIEN | STCIEN | RBDS | RDS_FIFO_EN | DE | RDS_FIFO_CLR | SOFTMUTE_EN | AFCD
+#else
+#define INIT_RX_REG_4	0x44	// RSVD | STCIEN | RBDS | RDS_FIFO_EN | DE | RDS_FIFO_CLR | SOFTMUTE_EN | AFCD
+#endif
+#define INIT_RX_REG_5	0x04	// RSVD | I2S_ENABLE | GPIO3 | GPIO3 | GPIO2 | GPIO2 | GPIO1 | GPIO1
+
+#define INIT_RX_REG_6	0x08	// INT _MODE | SEEK_MODE | SEEK_MODE | RSVD | SEEKTH | SEEKTH | SEEKTH | SEEKTH
+
+#else
 
 #define INIT_RX_REG_4	0x04	// RSVD | STCIEN | RBDS | RDS_FIFO_EN | DE | RDS_FIFO_CLR | SOFTMUTE_EN | AFCD
 #define INIT_RX_REG_5	0x00	// RSVD | I2S_ENABLE | GPIO3 | GPIO3 | GPIO2 | GPIO2 | GPIO1 | GPIO1
 
 #define INIT_RX_REG_6	0x88	// INT _MODE | SEEK_MODE | SEEK_MODE | RSVD | SEEKTH | SEEKTH | SEEKTH | SEEKTH
+
+#endif
 #define INIT_RX_REG_7	0x8F	// LNA_PORT_SEL | LNA_PORT_SEL | LNA_ICSEL_BIT | LNA_ICSEL_BIT | VOLUME | VOLUME | VOLUME | VOLUME
 
 #define INIT_RX_REG_8	0x00	// RSVD | OPEN_MODE | OPEN_MODE | SLAVE_MASTER | WS_LR | SCLK_I_EDGE | DATA_SIGNED | WS_I_EDGE
@@ -50,16 +172,55 @@
 #define INIT_RX_REG_10	0x42	// RSVD | TH_SOFRBLEND | TH_SOFRBLEND | TH_SOFRBLEND | TH_SOFRBLEND | TH_SOFRBLEND | 65M_50M MODE | RSVD
 #define INIT_RX_REG_11	0x02	// SEEK_TH_OLD | SEEK_TH_OLD | SEEK_TH_OLD | SEEK_TH_OLD | SEEK_TH_OLD | SEEK_TH_OLD | SOFTBLEND_EN | FREQ_MODE
 
-void initRDAFMReceiver(unsigned char volLvl, unsigned short channel);
-void updateReceiverConfig(unsigned char length);
-void seekChannel(unsigned char isSeekUp);
-void setRDAVolume(unsigned char volLvl);
-void setTunerFrequency(unsigned short channel);
-
-void getReceiverConfig(unsigned char length);
-void getTunerFrequency(unsigned char *freq);
-void getTunerChannel(unsigned short *channel);
-unsigned char isStereoChannel();
-unsigned char isStation();
+// RDA5807M specific functions (common functions are declared in tuner.h).
+unsigned char updateReceiverConfig();
+unsigned char applyReceiverConfig();
+unsigned char getReceiverConfig(unsigned char length);
+unsigned char collectReceiverConfig();
+void requestReceiverConfig(unsigned char length);
+unsigned char getStatusPollInterval();
+unsigned short getStatusBytesPerSec();
+
+// Register fields as (byte offset, bit position, width). Byte offsets of the
+// control fields are in rdaWriteReg (from 02H) and the status fields are in
+// rdaReadReg (from 0AH).
+#define FIELD_DMUTE             0, 6, 1     // 02H
+#define FIELD_SEEKUP            0, 1, 1
+#define FIELD_SEEK              0, 0, 1
+#define FIELD_SOFT_RESET        1, 1, 1
+#define FIELD_CHAN_HIGH         2, 0, 8     // 03H : CHAN[9:2]
+#define FIELD_CHAN_LOW          3, 6, 2     // CHAN[1:0]
+#define FIELD_TUNE              3, 4, 1
+#define FIELD_BAND              3, 2, 2
+#define FIELD_SPACE             3, 0, 2
+#define FIELD_SEEKTH            6, 0, 4     // 05H
+#define FIELD_VOLUME            7, 0, 4
+
+#define FIELD_RDSR              0, 7, 1     // 0AH
+#define FIELD_STC               0, 6, 1
+#define FIELD_SF                0, 5, 1
+#define FIELD_ST                0, 2, 1
+#define FIELD_READCHAN_HIGH     0, 0, 2     // READCHAN[9:8]
+#define FIELD_READCHAN_LOW      1, 0, 8     // READCHAN[7:0]
+#define FIELD_RSSI              2, 1, 7     // 0BH
+#define FIELD_FM_TRUE           2, 0, 1
+#define FIELD_BLER              3, 0, 4     // BLERA and BLERB
+
+// Field accessors, the extra level expands the field description into the
+// arguments (macros built on top of these use the "_" forms directly).
+// Constant single bit writes compile into BSET/BRES.
+#define FIELD_POS_(pos, shift, width)           (pos)
+#define FIELD_SHIFT_(pos, shift, width)         (shift)
+#define FIELD_MASK_(pos, shift, width)          ((unsigned char)(((1 << (width)) - 1) << (shift)))
+#define GET_FIELD_(reg, pos, shift, width)      (((reg)[pos] >> (shift)) & ((1 << (width)) - 1))
+#define TEST_FIELD_(reg, pos, shift, width)     ((reg)[pos] & FIELD_MASK_(pos, shift, width))
+#define PUT_FIELD_(reg, pos, shift, width, value)   \
+    ((reg)[pos] = ((reg)[pos] & (unsigned char)~FIELD_MASK_(pos, shift, width)) | (((value) << (shift)) & FIELD_MASK_(pos, shift, width)))
+
+#define FIELD_POS(field)                FIELD_POS_(field)
+#define FIELD_MASK(field)               FIELD_MASK_(field)
+#define GET_FIELD(reg, field)           GET_FIELD_(reg, field)
+#define TEST_FIELD(reg, field)          TEST_FIELD_(reg, field)
+#define PUT_FIELD(reg, field, value)    PUT_FIELD_(reg, field, value)
 
 #endif /* FM_MICRO_RDA5807M_HEADER */
\ No newline at end of file
@@ -0,0 +1,428 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// RDS (Radio Data System) decoder source file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Add clock-time (group 4A) decoding - SriKIT contributors.
+// [18/10/2026] - Add alternative frequency list decoding - SriKIT contributors.
+// [18/10/2026] - Report alternative frequencies independent of the band - SriKIT contributors.
+// [18/10/2026] - Keep the alternative frequencies of the last program for the PI search - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "rds.h"
+
+#ifdef RDS_CLOCK
+#include "rtc.h"
+#endif
+
+// Offsets of the RDS blocks (0CH - 0FH) in the group buffer.
+#define BLOCK_A     0
+#define BLOCK_B     2
+#define BLOCK_C     4
+#define BLOCK_D     6
+
+#define RDS_GROUP_LEN   8
+
+// Group type code (upper nibble of block B) and version B flag.
+#define RDS_GROUP_BASIC     0x00
+#define RDS_GROUP_TEXT      0x02
+#define RDS_GROUP_CLOCK     0x04
+#define RDS_VERSION_B       0x08
+
+#define RDS_TEXT_AB_FLAG    0x10
+#define RDS_TEXT_END        0x0D
+
+// Local time offset (in half hours) of the clock-time group.
+#define RDS_CLOCK_OFFSET_SIGN   0x20
+#define RDS_CLOCK_OFFSET_MASK   0x1F
+#define RDS_CLOCK_OFFSET_MAX    28
+
+// Alternative frequency codes of FM band.
+#define RDS_AF_FIRST_CODE   1
+#define RDS_AF_LAST_CODE    204
+
+// Vote weight of a block with the given error level.
+#define RDS_VOTE_WEIGHT(err)    (RDS_MAX_BLOCK_ERROR + 1 - (err))
+
+RDSVote rdsPI;
+RDSVote rdsPSVote[RDS_PS_SEGMENTS];
+RDSVote rdsRTVote[RDS_RT_SEGMENTS];
+
+// Accepted program service name and its accepted segments (bit 0 = segment 0).
+unsigned char rdsPSName[RDS_PS_LEN];
+unsigned char rdsPSReady;
+
+// Text A/B flag of the current RadioText (0xFF = unknown).
+unsigned char rdsRTFlag;
+
+#ifdef RDS_AF
+// Alternative frequency codes of the station with rdsAFPI code. The list is
+// kept over tune/seek and cleared only when a different PI is confirmed.
+unsigned char rdsAFList[RDS_AF_MAX];
+unsigned char rdsAFCount = 0;
+unsigned short rdsAFPI = 0;
+#endif
+
+// Last processed group, to skip the groups which are read more than once.
+unsigned char rdsLastGroup[RDS_GROUP_LEN];
+
+static unsigned char rdsVote(RDSVote *vote, unsigned char *value, unsigned char weight)
+{
+    if((vote->value[0] == value[0]) && (vote->value[1] == value[1]))
+    {
+        // Same value is received, increase the confidence.
+        vote->count = ((vote->count + weight) > RDS_VOTE_MAX) ? RDS_VOTE_MAX : (vote->count + weight);
+    }
+    else if(vote->count > weight)
+    {
+        // Different value is received, reduce the confidence of the candidate.
+        vote->count -= weight;
+    }
+    else
+    {
+        // Replace the weak candidate with the received value.
+        vote->value[0] = value[0];
+        vote->value[1] = value[1];
+        vote->count = weight;
+    }
+
+    return (vote->count >= RDS_VOTE_THRESHOLD);
+}
+
+static unsigned char rdsPrintable(unsigned char data)
+{
+    // Replace control and extended characters with space.
+    return ((data < 0x20) || (data > 0x7E)) ? ' ' : data;
+}
+
+void rdsReset()
+{
+    unsigned char pos = 0;
+
+    rdsPI.count = 0;
+    rdsPSReady = 0;
+    rdsRTFlag = 0xFF;
+
+    while(pos < RDS_RT_SEGMENTS)
+    {
+        if(pos < RDS_PS_SEGMENTS)
+        {
+            rdsPSVote[pos].count = 0;
+        }
+
+        rdsRTVote[pos].count = 0;
+        pos++;
+    }
+
+    pos = 0;
+    while(pos < RDS_GROUP_LEN)
+    {
+        rdsLastGroup[pos] = 0;
+        pos++;
+    }
+}
+
+#ifdef RDS_AF
+
+static void rdsAddAF(unsigned char code)
+{
+    unsigned char pos = 0;
+
+    if((code < RDS_AF_FIRST_CODE) || (code > RDS_AF_LAST_CODE))
+    {
+        // AF count, filler and LF/MF codes.
+        return;
+    }
+
+    while(pos < rdsAFCount)
+    {
+        if(rdsAFList[pos] == code)
+        {
+            // Frequency is already in the list.
+            return;
+        }
+
+        pos++;
+    }
+
+    if(rdsAFCount < RDS_AF_MAX)
+    {
+        rdsAFList[rdsAFCount++] = code;
+    }
+}
+
+static void rdsProcessAF(unsigned char *blocks)
+{
+    unsigned short pi;
+
+    // AF list belongs to the confirmed PI code.
+    if(!rdsGetPI(&pi))
+    {
+        return;
+    }
+
+    if(pi != rdsAFPI)
+    {
+        rdsAFPI = pi;
+        rdsAFCount = 0;
+    }
+
+    rdsAddAF(blocks[BLOCK_C]);
+    rdsAddAF(blocks[BLOCK_C + 1]);
+}
+
+#endif
+
+static void rdsProcessBasic(unsigned char *blocks, unsigned char weight)
+{
+    unsigned char segment = blocks[BLOCK_B + 1] & 0x03;
+
+#ifdef RDS_AF
+    // Block C of version A carries 2 alternative frequency codes. Error
+    // level of block C is unknown, so use only error free groups.
+    if((!(blocks[BLOCK_B] & RDS_VERSION_B)) && (weight == RDS_VOTE_WEIGHT(0)))
+    {
+        rdsProcessAF(blocks);
+    }
+#endif
+
+    // Block D carries 2 characters of the program service name.
+    if(rdsVote(&rdsPSVote[segment], &blocks[BLOCK_D], weight))
+    {
+        rdsPSName[segment * 2] = rdsPSVote[segment].value[0];
+        rdsPSName[(segment * 2) + 1] = rdsPSVote[segment].value[1];
+        rdsPSReady |= (1 << segment);
+    }
+}
+
+static void rdsProcessText(unsigned char *blocks, unsigned char weight)
+{
+    unsigned char address = blocks[BLOCK_B + 1] & 0x0F;
+    unsigned char textFlag = blocks[BLOCK_B + 1] & RDS_TEXT_AB_FLAG;
+    unsigned char pos = 0;
+
+    if(textFlag != rdsRTFlag)
+    {
+        // Change of the A/B flag clears the RadioText.
+        rdsRTFlag = textFlag;
+        while(pos < RDS_RT_SEGMENTS)
+        {
+            rdsRTVote[pos].count = 0;
+            pos++;
+        }
+    }
+
+    if(blocks[BLOCK_B] & RDS_VERSION_B)
+    {
+        // Version B: 2 characters in block D (block C holds the PI).
+        rdsVote(&rdsRTVote[address], &blocks[BLOCK_D], weight);
+    }
+    else
+    {
+        // Version A: 4 characters in blocks C and D.
+        rdsVote(&rdsRTVote[address * 2], &blocks[BLOCK_C], weight);
+        rdsVote(&rdsRTVote[(address * 2) + 1], &blocks[BLOCK_D], weight);
+    }
+}
+
+#ifdef RDS_CLOCK
+
+static void rdsProcessClock(unsigned char *blocks)
+{
+    unsigned char hour = ((blocks[BLOCK_C + 1] & 0x01) << 4) | (blocks[BLOCK_D] >> 4);
+    unsigned char minute = ((blocks[BLOCK_D] & 0x0F) << 2) | (blocks[BLOCK_D + 1] >> 6);
+    unsigned char offset = blocks[BLOCK_D + 1] & RDS_CLOCK_OFFSET_MASK;
+    unsigned short localTime;
+
+    if((hour > 23) || (minute > 59) || (offset > RDS_CLOCK_OFFSET_MAX))
+    {
+        // Invalid clock-time (most likely due to undetected block errors).
+        return;
+    }
+
+    // Convert UTC into local time (in minutes of the day).
+    localTime = (hour * 60) + minute + 1440;
+    if(blocks[BLOCK_D + 1] & RDS_CLOCK_OFFSET_SIGN)
+    {
+        localTime -= (offset * 30);
+    }
+    else
+    {
+        localTime += (offset * 30);
+    }
+
+    localTime %= 1440;
+    rtcSync(localTime / 60, localTime % 60);
+}
+
+#endif
+
+void rdsProcessGroup(unsigned char *blocks, unsigned char blockErrors)
+{
+    unsigned char errorA = (blockErrors >> 2) & 0x03;
+    unsigned char errorB = blockErrors & 0x03;
+    unsigned char isRepeated = 1;
+    unsigned char pos = 0;
+
+    // RDSR remains set until the next group is received, so the same group
+    // can be read more than once.
+    while(pos < RDS_GROUP_LEN)
+    {
+        if(rdsLastGroup[pos] != blocks[pos])
+        {
+            rdsLastGroup[pos] = blocks[pos];
+            isRepeated = 0;
+        }
+
+        pos++;
+    }
+
+    if(isRepeated)
+    {
+        return;
+    }
+
+    // Every group starts with the PI code.
+    if(errorA <= RDS_MAX_BLOCK_ERROR)
+    {
+        rdsVote(&rdsPI, &blocks[BLOCK_A], RDS_VOTE_WEIGHT(errorA));
+    }
+
+    // Group type and address are in block B. Receiver does not report the
+    // error level of blocks C and D, so they are weighted with block B.
+    if(errorB > RDS_MAX_BLOCK_ERROR)
+    {
+        return;
+    }
+
+    switch(blocks[BLOCK_B] >> 4)
+    {
+    case RDS_GROUP_BASIC:
+        rdsProcessBasic(blocks, RDS_VOTE_WEIGHT(errorB));
+        break;
+    case RDS_GROUP_TEXT:
+        rdsProcessText(blocks, RDS_VOTE_WEIGHT(errorB));
+        break;
+#ifdef RDS_CLOCK
+    case RDS_GROUP_CLOCK:
+        // Clock-time is not voted (sent once per minute), so accept only
+        // error free version A groups.
+        if((errorB == 0) && (!(blocks[BLOCK_B] & RDS_VERSION_B)))
+        {
+            rdsProcessClock(blocks);
+        }
+        break;
+#endif
+    }
+}
+
+unsigned char rdsGetPI(unsigned short *pi)
+{
+    if(rdsPI.count < RDS_VOTE_THRESHOLD)
+    {
+        // PI code is not yet confirmed.
+        return 0;
+    }
+
+    (*pi) = ((unsigned short)rdsPI.value[0] << 8) | rdsPI.value[1];
+    return 1;
+}
+
+unsigned char rdsGetStationName(unsigned char *name)
+{
+    unsigned char pos = 0;
+
+    if(rdsPSReady != ((1 << RDS_PS_SEGMENTS) - 1))
+    {
+        // Some segments of the name are not yet received.
+        return 0;
+    }
+
+    while(pos < RDS_PS_LEN)
+    {
+        name[pos] = rdsPrintable(rdsPSName[pos]);
+        pos++;
+    }
+
+    return 1;
+}
+
+unsigned char rdsGetRadioText(unsigned char *text)
+{
+    unsigned char pos = 0;
+    unsigned char data;
+
+    // Copy the confirmed part of the text up to the end marker.
+    while(pos < RDS_RT_LEN)
+    {
+        if(rdsRTVote[pos >> 1].count < RDS_VOTE_THRESHOLD)
+        {
+            break;
+        }
+
+        data = rdsRTVote[pos >> 1].value[pos & 0x01];
+        if(data == RDS_TEXT_END)
+        {
+            break;
+        }
+
+        text[pos] = rdsPrintable(data);
+        pos++;
+    }
+
+    return pos;
+}
+
+#ifdef RDS_AF
+
+unsigned char rdsGetAFList(unsigned short *frequencies)
+{
+    unsigned short pi;
+
+    if(!rdsGetPI(&pi))
+    {
+        // PI code of the current station is not confirmed yet.
+        return 0;
+    }
+
+    return rdsGetProgramAFList(pi, frequencies);
+}
+
+unsigned char rdsGetProgramAFList(unsigned short pi, unsigned short *frequencies)
+{
+    unsigned char pos = 0;
+
+    if(pi != rdsAFPI)
+    {
+        // List belongs to a different program.
+        return 0;
+    }
+
+    while(pos < rdsAFCount)
+    {
+        frequencies[pos] = RDS_AF_FREQUENCY(rdsAFList[pos]);
+        pos++;
+    }
+
+    return rdsAFCount;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// RDS (Radio Data System) decoder header file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Add clock-time (group 4A) decoding - SriKIT contributors.
+// [18/10/2026] - Add alternative frequency list decoding - SriKIT contributors.
+// [18/10/2026] - Report alternative frequencies independent of the band - SriKIT contributors.
+// [18/10/2026] - Keep the alternative frequencies of the last program for the PI search - SriKIT contributors.
+// [18/10/2026] - Move the feature dependency checks into the feature headers - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#ifndef FM_MICRO_RDS_HEADER
+#define FM_MICRO_RDS_HEADER
+
+#define RDS_PS_LEN      8       // Program service name (group 0A/0B).
+#define RDS_RT_LEN      64      // RadioText (group 2A/2B).
+
+#define RDS_PS_SEGMENTS (RDS_PS_LEN / 2)
+#define RDS_RT_SEGMENTS (RDS_RT_LEN / 2)
+
+// Highest accepted block error level (BLERA/BLERB of 0BH). Level 0 is error
+// free, 1 is 1-2 corrected errors, 2 is 3-5 corrected errors and 3 is
+// uncorrectable.
+#ifndef RDS_MAX_BLOCK_ERROR
+#define RDS_MAX_BLOCK_ERROR     1
+#endif
+
+// Votes (weighted with the block error level) required to accept a value.
+#ifndef RDS_VOTE_THRESHOLD
+#define RDS_VOTE_THRESHOLD      3
+#endif
+
+#define RDS_VOTE_MAX            6
+
+#ifdef RDS_AF
+
+// Maximum number of alternative frequencies stored for the current PI code.
+#ifndef RDS_AF_MAX
+#define RDS_AF_MAX      8
+#endif
+
+// Frequency (in 100kHz units) of AF code 1 - 204 (87.5MHz + code * 100kHz).
+#define RDS_AF_FREQUENCY(code)  (875 + (unsigned short)(code))
+
+#endif
+
+// Candidate value of a 2 byte RDS field and its confidence.
+typedef struct RDSVote
+{
+    unsigned char value[2];
+    unsigned char count;
+} RDSVote;
+
+void rdsReset();
+void rdsProcessGroup(unsigned char *blocks, unsigned char blockErrors);
+
+unsigned char rdsGetPI(unsigned short *pi);
+unsigned char rdsGetStationName(unsigned char *name);
+unsigned char rdsGetRadioText(unsigned char *text);
+
+#ifdef RDS_AF
+unsigned char rdsGetAFList(unsigned short *frequencies);
+unsigned char rdsGetProgramAFList(unsigned short pi, unsigned short *frequencies);
+#endif
+
+#endif /* FM_MICRO_RDS_HEADER */
\ No newline at end of file
@@ -0,0 +1,146 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Software real-time clock source file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "include/stm8.h"
+#include "rtc.h"
+
+unsigned char rtcHour = 0;
+unsigned char rtcMinute = 0;
+unsigned char rtcSecond = 0;
+unsigned char rtcValid = 0;
+
+// Fraction of the current second and the drift correction applied every second.
+signed short rtcFraction = 0;
+signed short rtcTrim = 0;
+
+// Seconds since the last synchronization (saturated at 0xFFFF).
+unsigned short rtcSyncAge = 0;
+
+void rtcTick()
+{
+    rtcFraction += RTC_TICK_STEP;
+    if(rtcFraction < RTC_SECOND_STEPS)
+    {
+        return;
+    }
+
+    // One second is elapsed, apply the drift correction to the next second.
+    rtcFraction = rtcFraction - RTC_SECOND_STEPS + rtcTrim;
+
+    if(rtcSyncAge != 0xFFFF)
+    {
+        rtcSyncAge++;
+    }
+
+    if((++rtcSecond) < 60)
+    {
+        return;
+    }
+
+    rtcSecond = 0;
+    if((++rtcMinute) < 60)
+    {
+        return;
+    }
+
+    rtcMinute = 0;
+    if((++rtcHour) > 23)
+    {
+        rtcHour = 0;
+    }
+}
+
+void rtcSync(unsigned char hour, unsigned char minute)
+{
+    signed long error = 0;
+    signed short fraction;
+    unsigned short age;
+    signed short trim;
+
+    __critical
+    {
+        // Offset of the clock from the received time (in seconds).
+        age = rtcSyncAge;
+        fraction = rtcFraction;
+        if(rtcValid)
+        {
+            error = ((((signed short)rtcHour - hour) * 60) + ((signed short)rtcMinute - minute)) * 60L + rtcSecond;
+        }
+
+        // Received time marks the beginning of the minute.
+        rtcHour = hour;
+        rtcMinute = minute;
+        rtcSecond = 0;
+        rtcFraction = 0;
+        rtcSyncAge = 0;
+        rtcValid = 1;
+    }
+
+    // Midnight wrap around.
+    if(error > 43200L)
+    {
+        error -= 86400L;
+    }
+    else if(error < -43200L)
+    {
+        error += 86400L;
+    }
+
+    if((age < RTC_TRIM_MIN_AGE) || (error >= RTC_TRIM_MAX_ERROR) || (error <= -RTC_TRIM_MAX_ERROR))
+    {
+        // Interval is too short to measure the drift, or the clock is off by
+        // more than the drift (missed or corrupted update).
+        return;
+    }
+
+    // Spread the measured error (in RTC_SECOND_STEPS units) over the seconds
+    // of the interval.
+    error = (error * RTC_SECOND_STEPS) + fraction;
+    trim = rtcTrim - (signed short)(error / age);
+    if(trim > RTC_TRIM_LIMIT)
+    {
+        trim = RTC_TRIM_LIMIT;
+    }
+    else if(trim < -RTC_TRIM_LIMIT)
+    {
+        trim = -RTC_TRIM_LIMIT;
+    }
+
+    __critical
+    {
+        rtcTrim = trim;
+    }
+}
+
+unsigned char rtcGetTime(unsigned char *hour, unsigned char *minute)
+{
+    __critical
+    {
+        (*hour) = rtcHour;
+        (*minute) = rtcMinute;
+    }
+
+    return rtcValid;
+}
\ No newline at end of file
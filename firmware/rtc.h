@@ -0,0 +1,51 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Software real-time clock header file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Check the RDS dependency - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#ifndef FM_MICRO_RTC_HEADER
+#define FM_MICRO_RTC_HEADER
+
+#ifndef RDA_RDS
+#error "RDS_CLOCK requires RDA_RDS"
+#endif
+
+// rtcTick is called at 195.3125Hz (display timer), which is 25000 / 128.
+// Each tick adds RTC_TICK_STEP into the fraction of the current second.
+#define RTC_TICK_STEP       128
+#define RTC_SECOND_STEPS    25000
+
+// Minimum time (in seconds) between two synchronizations to update the
+// drift correction, and the maximum error which is treated as drift.
+#define RTC_TRIM_MIN_AGE    600
+#define RTC_TRIM_MAX_ERROR  30
+
+// Limit of the drift correction (in RTC_SECOND_STEPS units per second).
+#define RTC_TRIM_LIMIT      1000
+
+void rtcTick();
+void rtcSync(unsigned char hour, unsigned char minute);
+unsigned char rtcGetTime(unsigned char *hour, unsigned char *minute);
+
+#endif /* FM_MICRO_RTC_HEADER */
\ No newline at end of file
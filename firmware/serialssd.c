@@ -21,6 +21,8 @@
 //
 // Update log:
 // [26/12/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Add ASCII character set for text display - SriKIT contributors.
+// [18/10/2026] - Add bar graph characters - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #include "include/stm8.h"
@@ -32,6 +34,14 @@
 // PC4 : Latch Data.
 // PC5 : Serial Clock.
 
+// Segment patterns of the letters A - Z (approximated for 7 segments).
+const unsigned char ssdLetters[26] = {
+    0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71, 0x3D,   // A b C d E F G
+    0x76, 0x30, 0x1E, 0x75, 0x38, 0x37, 0x54,   // H I J K L M n
+    0x3F, 0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E,   // O P q r S t U
+    0x1C, 0x2A, 0x76, 0x6E, 0x5B                // v W X Y Z
+    };
+
 void setDigitValue(unsigned char ssdValue)
 {
     unsigned char pos = 7;
@@ -57,6 +67,13 @@ void setDigitValue(unsigned char ssdValue)
 
 unsigned char getDigitValue(unsigned char num, unsigned char clearOnZero)
 {
+    if((num >= '0') && (num <= '9'))
+    {
+        // ASCII digits are displayed as numbers (zero is never cleared).
+        num -= '0';
+        clearOnZero = 0;
+    }
+
     switch (num)
     {
     case 0:
@@ -81,7 +98,27 @@ unsigned char getDigitValue(unsigned char num, unsigned char clearOnZero)
         return 0x6F;    // Character : 9
     case 46:
         return 0x80;    // Character : dot
-    default:
-        return 0x00;    // Clear segment.
+    case '-':
+        return 0x40;    // Character : -
+    case '_':
+        return 0x08;    // Character : _
+    case '|':
+        return 0x30;    // Character : left half bar
+    case '#':
+        return 0x36;    // Character : full bar
     }
+
+    // ASCII letters (used to display text).
+    if((num >= 'A') && (num <= 'Z'))
+    {
+        return ssdLetters[num - 'A'];
+    }
+
+    if((num >= 'a') && (num <= 'z'))
+    {
+        return ssdLetters[num - 'a'];
+    }
+
+    // Clear segment.
+    return 0x00;
 }
\ No newline at end of file
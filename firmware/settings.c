@@ -0,0 +1,143 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Wear leveled settings journal source file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Program the record as a single EEPROM word - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "include/stm8-eeprom.h"
+
+#include "settings.h"
+
+#ifdef STATION_MAP
+#include "stationmap.h"
+
+#if (STATION_MAP_SIZE > 16)
+#error "STATION_MAP_SIZE above 16 overlaps the settings journal"
+#endif
+#endif
+
+// Journal slots, placed in the EEPROM words not used by the presets, the band
+// configuration, the preset PI codes and the station map.
+static const unsigned short settingsSlots[SETTINGS_SLOT_COUNT] =
+{
+    (EEPROM_START_ADDR + 0x1C), (EEPROM_START_ADDR + 0x38), (EEPROM_START_ADDR + 0x3C),
+    (EEPROM_START_ADDR + 0x64), (EEPROM_START_ADDR + 0x68), (EEPROM_START_ADDR + 0x6C),
+    (EEPROM_START_ADDR + 0x70), (EEPROM_START_ADDR + 0x74), (EEPROM_START_ADDR + 0x78),
+    (EEPROM_START_ADDR + 0x7C)
+};
+
+unsigned char settingsVolume;
+unsigned short settingsChannel;
+unsigned char settingsSeq = 0;
+unsigned char settingsSlot = SETTINGS_SLOT_COUNT - 1;
+
+static unsigned char getSettingsCheck(unsigned char *record)
+{
+    return record[0] ^ record[1] ^ record[2] ^ SETTINGS_CHECK_SEED;
+}
+
+static unsigned char readSettingsRecord(unsigned char slot, unsigned char *record)
+{
+    unsigned short memAddr = settingsSlots[slot];
+
+    record[0] = eepromRead(memAddr);
+    record[1] = eepromRead(memAddr + 1);
+    record[2] = eepromRead(memAddr + 2);
+
+    return (record[0] != 0) && (eepromRead(memAddr + 3) == getSettingsCheck(record));
+}
+
+void settingsLoad(unsigned char *volume, unsigned short *channel)
+{
+    unsigned char slot = 0;
+    unsigned char record[SETTINGS_RECORD_SIZE - 1];
+    unsigned char found = 0;
+
+    // Find the valid record with the highest (wrapping) sequence number.
+    while(slot < SETTINGS_SLOT_COUNT)
+    {
+        if(readSettingsRecord(slot, record) && ((!found) || ((signed char)(record[0] - settingsSeq) > 0)))
+        {
+            found = 1;
+            settingsSeq = record[0];
+            settingsSlot = slot;
+            settingsVolume = record[1] & SETTINGS_VOLUME_MASK;
+            settingsChannel = ((unsigned short)(record[1] & 0xC0) << 2) | record[2];
+        }
+
+        slot++;
+    }
+
+    if(!found)
+    {
+        // Journal is empty, use the settings saved by the older firmware.
+        settingsVolume = eepromRead(EEPROM_VOLUME_ADDRESS);
+        settingsChannel = ((unsigned short)eepromRead(EEPROM_TUNE_CHANNEL_ADDRESS) << 8) | (eepromRead(EEPROM_TUNE_CHANNEL_ADDRESS + 1));
+    }
+
+    (*volume) = settingsVolume;
+    (*channel) = settingsChannel;
+}
+
+static void writeSettingsRecord()
+{
+    unsigned char record[SETTINGS_RECORD_SIZE];
+
+    // Sequence number 0 marks the empty slot.
+    if((++settingsSeq) == 0)
+    {
+        settingsSeq = 1;
+    }
+
+    if((++settingsSlot) >= SETTINGS_SLOT_COUNT)
+    {
+        settingsSlot = 0;
+    }
+
+    record[0] = settingsSeq;
+    record[1] = (settingsVolume & SETTINGS_VOLUME_MASK) | ((settingsChannel >> 2) & 0xC0);
+    record[2] = settingsChannel & 0xFF;
+    record[3] = getSettingsCheck(record);
+
+    // Record is programmed as a single word, an interrupted write fails the
+    // check and the previous record stays as the latest one.
+    eepromWriteWord(settingsSlots[settingsSlot], record);
+}
+
+void settingsSaveVolume(unsigned char volume)
+{
+    if(volume != settingsVolume)
+    {
+        settingsVolume = volume;
+        writeSettingsRecord();
+    }
+}
+
+void settingsSaveChannel(unsigned short channel)
+{
+    if(channel != settingsChannel)
+    {
+        settingsChannel = channel;
+        writeSettingsRecord();
+    }
+}
\ No newline at end of file
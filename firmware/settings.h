@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Wear leveled settings journal header file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#ifndef FM_MICRO_SETTINGS_HEADER
+#define FM_MICRO_SETTINGS_HEADER
+
+#include "include/stm8.h"
+
+// Settings are kept as a journal of full state records in the free 4 byte
+// aligned EEPROM words, each new record goes into the slot after the latest
+// one (and replaces the oldest record). Record layout:
+//   [0] sequence number (1 - 255, 0 = empty slot)
+//   [1] volume level (bit 0 - 5) and tuner channel bit 8 - 9 (bit 6 - 7)
+//   [2] tuner channel bit 0 - 7
+//   [3] check byte
+#define SETTINGS_RECORD_SIZE    4
+#define SETTINGS_SLOT_COUNT     10
+
+#define SETTINGS_VOLUME_MASK    0x3F
+#define SETTINGS_CHECK_SEED     0xA5
+
+// Fixed locations of the volume and tuner channel used by the older firmware
+// (loaded if the journal is empty).
+#define EEPROM_VOLUME_ADDRESS   (EEPROM_START_ADDR + 1)
+#define EEPROM_TUNE_CHANNEL_ADDRESS   (EEPROM_START_ADDR + 2)
+
+void settingsLoad(unsigned char *volume, unsigned short *channel);
+void settingsSaveVolume(unsigned char volume);
+void settingsSaveChannel(unsigned short channel);
+
+#endif /* FM_MICRO_SETTINGS_HEADER */
\ No newline at end of file
@@ -0,0 +1,276 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Cached station map source file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Validate channels against the selected band - SriKIT contributors.
+// [18/10/2026] - Use the tuner interface - SriKIT contributors.
+// [18/10/2026] - Seek for the unmapped stations and tolerate missed jumps - SriKIT contributors.
+// [18/10/2026] - Expose the mapped stations to the PI search - SriKIT contributors.
+// [18/10/2026] - Store the channels in EEPROM words and the count after them - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "include/stm8-eeprom.h"
+
+#include "tuner.h"
+#include "stationmap.h"
+
+// Known stations in ascending channel order, and the number of failed
+// jumps into each station.
+unsigned short stationMap[STATION_MAP_SIZE];
+unsigned char stationMapMisses[STATION_MAP_SIZE];
+unsigned char stationMapCount = 0;
+unsigned char stationMapDirty = 0;
+
+// Jumps since the last seek (which refreshes the map with the stations found).
+unsigned char stationMapJumps = 0;
+
+void stationMapLoad()
+{
+    unsigned char pos = 0;
+    unsigned short memAddr = EEPROM_STATION_MAP_BASE;
+
+    stationMapCount = eepromRead(EEPROM_STATION_MAP_COUNT);
+    if(stationMapCount > STATION_MAP_SIZE)
+    {
+        // Map is invalid or first time load.
+        stationMapCount = 0;
+    }
+
+    while(pos < stationMapCount)
+    {
+        stationMap[pos] = ((unsigned short)eepromRead(memAddr) << 8) | (eepromRead(memAddr + 1));
+        if((stationMap[pos] > getMaxTunerChannel()) || ((pos > 0) && (stationMap[pos] <= stationMap[pos - 1])))
+        {
+            // Channel is invalid or out of order, drop the rest of the map.
+            stationMapCount = pos;
+            break;
+        }
+
+        stationMapMisses[pos] = 0;
+        memAddr += 2;
+        pos++;
+    }
+
+    stationMapDirty = 0;
+}
+
+void stationMapSave()
+{
+    unsigned char word[EEPROM_WORD_SIZE];
+    unsigned char pos = 0;
+
+    if(!stationMapDirty)
+    {
+        return;
+    }
+
+    // Program 2 channels in each EEPROM word, only the modified words are written.
+    while(pos < stationMapCount)
+    {
+        word[0] = (stationMap[pos] >> 8) & 0xFF;
+        word[1] = stationMap[pos] & 0xFF;
+
+        if((pos + 1) < stationMapCount)
+        {
+            word[2] = (stationMap[pos + 1] >> 8) & 0xFF;
+            word[3] = stationMap[pos + 1] & 0xFF;
+        }
+
+        eepromWriteBlock((EEPROM_STATION_MAP_BASE + (pos * 2)), word, (((pos + 1) < stationMapCount) ? EEPROM_WORD_SIZE : 2));
+        pos += 2;
+    }
+
+    if(eepromRead(EEPROM_STATION_MAP_COUNT) != stationMapCount)
+    {
+        eepromWrite(EEPROM_STATION_MAP_COUNT, stationMapCount);
+    }
+
+    stationMapDirty = 0;
+}
+
+void stationMapAdd(unsigned short channel)
+{
+    unsigned char pos = 0;
+    unsigned char shift = stationMapCount;
+
+    // Find the position of the channel in the ordered map.
+    while((pos < stationMapCount) && (stationMap[pos] < channel))
+    {
+        pos++;
+    }
+
+    if((pos < stationMapCount) && (stationMap[pos] == channel))
+    {
+        // Station is already known and found again.
+        stationMapMisses[pos] = 0;
+        return;
+    }
+
+    if(stationMapCount >= STATION_MAP_SIZE)
+    {
+        // Map is full (space is released when the stale stations are removed).
+        return;
+    }
+
+    while(shift > pos)
+    {
+        stationMap[shift] = stationMap[shift - 1];
+        stationMapMisses[shift] = stationMapMisses[shift - 1];
+        shift--;
+    }
+
+    stationMap[pos] = channel;
+    stationMapMisses[pos] = 0;
+    stationMapCount++;
+    stationMapDirty = 1;
+}
+
+void stationMapRemove(unsigned short channel)
+{
+    unsigned char pos = 0;
+
+    while((pos < stationMapCount) && (stationMap[pos] != channel))
+    {
+        pos++;
+    }
+
+    if(pos == stationMapCount)
+    {
+        // Channel is not in the map.
+        return;
+    }
+
+    stationMapCount--;
+    while(pos < stationMapCount)
+    {
+        stationMap[pos] = stationMap[pos + 1];
+        stationMapMisses[pos] = stationMapMisses[pos + 1];
+        pos++;
+    }
+
+    stationMapDirty = 1;
+}
+
+void stationMapClear()
+{
+    stationMapCount = 0;
+    stationMapDirty = 1;
+}
+
+static unsigned char stationMapNext(unsigned short channel, unsigned char isSeekUp)
+{
+    unsigned char pos = 0;
+
+    if(isSeekUp)
+    {
+        // First known station above the channel.
+        while(pos < stationMapCount)
+        {
+            if(stationMap[pos] > channel)
+            {
+                return pos;
+            }
+
+            pos++;
+        }
+    }
+    else
+    {
+        // First known station below the channel.
+        pos = stationMapCount;
+        while(pos > 0)
+        {
+            pos--;
+            if(stationMap[pos] < channel)
+            {
+                return pos;
+            }
+        }
+    }
+
+    return STATION_MAP_NONE;
+}
+
+unsigned char stationMapJump(unsigned char isSeekUp)
+{
+    unsigned short channel;
+    unsigned short nextChannel;
+    unsigned short jumpRange;
+    unsigned char pos;
+
+    // Seek periodically to find the stations which are not in the map yet.
+    if(stationMapJumps >= STATION_MAP_JUMP_LIMIT)
+    {
+        stationMapJumps = 0;
+        return 0;
+    }
+
+    getTunerChannel(&channel);
+    jumpRange = (STATION_MAP_JUMP_RANGE << 2) >> getTunerSpacing();
+
+    while((pos = stationMapNext(channel, isSeekUp)) != STATION_MAP_NONE)
+    {
+        nextChannel = stationMap[pos];
+        if(((nextChannel > channel) ? (nextChannel - channel) : (channel - nextChannel)) > jumpRange)
+        {
+            // Next known station is far away, seek to find the stations in between.
+            break;
+        }
+
+        // Tune directly into the next known station.
+        setTunerFrequency(nextChannel);
+        waitReceiverTune(STATION_MAP_TUNE_TIMEOUT);
+        tunerRefreshStatus();
+
+        if(isStation())
+        {
+            stationMapMisses[pos] = 0;
+            stationMapJumps++;
+            return 1;
+        }
+
+        // Station is not received, drop it after repeated misses and try
+        // the next one.
+        if((++stationMapMisses[pos]) >= STATION_MAP_MISS_LIMIT)
+        {
+            stationMapRemove(nextChannel);
+        }
+
+        channel = nextChannel;
+    }
+
+    // There are no (valid) known stations nearby, seek from the current channel.
+    stationMapJumps = 0;
+    return 0;
+}
+
+unsigned char stationMapGet(unsigned char pos, unsigned short *channel)
+{
+    if(pos >= stationMapCount)
+    {
+        // No more known stations.
+        return 0;
+    }
+
+    (*channel) = stationMap[pos];
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Cached station map header file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Add map clear for band changes - SriKIT contributors.
+// [18/10/2026] - Add jump range, seek refresh and miss limits - SriKIT contributors.
+// [18/10/2026] - Expose the mapped stations to the PI search - SriKIT contributors.
+// [18/10/2026] - Store the channels in EEPROM words and the count after them - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#ifndef FM_MICRO_STATION_MAP_HEADER
+#define FM_MICRO_STATION_MAP_HEADER
+
+#include "include/stm8.h"
+
+// Maximum number of stations in the map.
+#ifndef STATION_MAP_SIZE
+#define STATION_MAP_SIZE    16
+#endif
+
+// EEPROM location of the map: word aligned channels (2 in each EEPROM word)
+// followed by the number of stations.
+#define EEPROM_STATION_MAP_BASE     (EEPROM_START_ADDR + 64)
+#define EEPROM_STATION_MAP_COUNT    (EEPROM_STATION_MAP_BASE + (STATION_MAP_SIZE * 2))
+
+#if (STATION_MAP_SIZE > 16)
+#error "STATION_MAP_SIZE overlaps the settings journal"
+#endif
+
+// Timeout (in ms) of the tune into a mapped station.
+#define STATION_MAP_TUNE_TIMEOUT    100
+
+// Largest distance (in 100kHz units) of a jump, stations further away are
+// reached with a seek (which also finds the unmapped stations in between).
+#ifndef STATION_MAP_JUMP_RANGE
+#define STATION_MAP_JUMP_RANGE      20
+#endif
+
+// Jumps before the next seek refreshes the map, and the failed jumps into a
+// station before it is removed from the map.
+#define STATION_MAP_JUMP_LIMIT      8
+#define STATION_MAP_MISS_LIMIT      3
+
+#define STATION_MAP_NONE            0xFF
+
+void stationMapLoad();
+void stationMapSave();
+void stationMapAdd(unsigned short channel);
+void stationMapRemove(unsigned short channel);
+void stationMapClear();
+unsigned char stationMapJump(unsigned char isSeekUp);
+unsigned char stationMapGet(unsigned char pos, unsigned short *channel);
+
+#endif /* FM_MICRO_STATION_MAP_HEADER */
\ No newline at end of file
@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Tuner interface source file (functions common to all the backends).
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [18th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Reject off-grid frequencies and report unsupported band spacing - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "tuner.h"
+
+const TunerBandRange tunerBands[bdCount] = {
+    {870, 1080},    // 87 - 108MHz
+    {760, 910},     // 76 - 91MHz
+    {760, 1080},    // 76 - 108MHz
+    {650, 760}      // 65 - 76MHz
+    };
+
+// Decimal weights of the first 3 frequency digits.
+const unsigned short tunerDigitWeights[3] = {1000, 100, 10};
+
+// Last converted channel (with the band and spacing in the upper bits) and
+// its frequency digits.
+unsigned short tunerFreqKey = 0xFFFF;
+unsigned char tunerFreqDigits[4];
+
+static void convertFrequency(unsigned short tunedFreq)
+{
+    unsigned char pos = 0;
+    unsigned char digit;
+
+    // Frequency is below 10000, so subtract the decimal weights instead of
+    // dividing (at most 19 subtractions).
+    while(pos < 3)
+    {
+        digit = 0;
+        while(tunedFreq >= tunerDigitWeights[pos])
+        {
+            tunedFreq -= tunerDigitWeights[pos];
+            digit++;
+        }
+
+        tunerFreqDigits[pos] = digit;
+        pos++;
+    }
+
+    tunerFreqDigits[3] = tunedFreq;
+}
+
+void getTunerFrequency(unsigned char *freq)
+{
+    unsigned short channel;
+    unsigned short key;
+
+    getTunerChannel(&channel);
+    key = channel | ((unsigned short)((getTunerBand() << 2) | getTunerSpacing()) << 12);
+
+    if(key != tunerFreqKey)
+    {
+        // Convert channel into frequency (in 100kHz units) of the selected
+        // band and spacing, only when the channel is changed.
+        tunerFreqKey = key;
+        convertFrequency(tunerBands[getTunerBand()].minFreq + ((channel << getTunerSpacing()) >> 2));
+    }
+
+    // Copy the 4 digit number.
+    freq[0] = tunerFreqDigits[0];
+    freq[1] = tunerFreqDigits[1];
+    freq[2] = tunerFreqDigits[2];
+    freq[3] = tunerFreqDigits[3];
+}
+
+unsigned short getMaxTunerChannel()
+{
+    const TunerBandRange *band = &tunerBands[getTunerBand()];
+    unsigned short maxChannel = ((band->maxFreq - band->minFreq) << 2) >> getTunerSpacing();
+
+    // Narrow spacing of the wide bands may exceed the channel range of the tuner.
+    return (maxChannel > getTunerChannelLimit()) ? getTunerChannelLimit() : maxChannel;
+}
+
+unsigned short getFrequencyChannel(unsigned short freq)
+{
+    const TunerBandRange *band = &tunerBands[getTunerBand()];
+
+    if((freq < band->minFreq) || (freq > band->maxFreq))
+    {
+        // Frequency (in 100kHz units) is outside of the band.
+        return 0xFFFF;
+    }
+
+    // Offset in 25kHz steps, the steps between the channels are off-grid.
+    freq = (freq - band->minFreq) << 2;
+    if(freq & ((1 << getTunerSpacing()) - 1))
+    {
+        return 0xFFFF;
+    }
+
+    freq >>= getTunerSpacing();
+    return (freq > getTunerChannelLimit()) ? 0xFFFF : freq;
+}
+
+unsigned char isTunerBandSupported(unsigned char band, unsigned char spacing)
+{
+    // Channels of the whole band must fit into the channel range of the tuner.
+    return ((((tunerBands[band].maxFreq - tunerBands[band].minFreq) << 2) >> spacing) <= getTunerChannelLimit());
+}
\ No newline at end of file
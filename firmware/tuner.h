@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Tuner interface header file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [19th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [18/10/2026] - Make the interface independent of the receiver chip - SriKIT contributors.
+// [18/10/2026] - Add band and spacing support check - SriKIT contributors.
+// [19/10/2026] - Reject TUNER_INT with the simulated backend - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#ifndef FM_MICRO_TUNER_HEADER
+#define FM_MICRO_TUNER_HEADER
+
+#include "include/stm8.h"
+
+// Tuner backend is selected at compile time (TUNER_<chip> define of the
+// Makefile). Backend source file implements all the functions of this
+// interface except the common ones in tuner.c, and its own header is only
+// included by the backend.
+#if !defined(TUNER_RDA5807M) && !defined(TUNER_SIM)
+#error "Unsupported tuner backend (TUNER_RDA5807M and TUNER_SIM are available)"
+#endif
+
+enum TuneState
+{
+    tnIdle,
+    tnBusy,
+    tnDone,
+    tnFailed,
+    tnTimeout
+};
+
+// Receiver fault codes.
+enum TunerFault
+{
+    tfNone,
+    tfNoResponse,
+    tfChipId,
+    tfConfig
+};
+
+// FM bands, the frequency ranges are in tunerBands.
+enum TunerBand
+{
+    bdWorld,        // 87 - 108MHz
+    bdJapan,        // 76 - 91MHz
+    bdWide,         // 76 - 108MHz
+    bdEast,         // 65 - 76MHz
+    bdCount
+};
+
+// Channel spacing, the channel step is 25kHz << spacing.
+enum TunerSpacing
+{
+    sp25kHz,
+    sp50kHz,
+    sp100kHz,
+    sp200kHz,
+    spCount
+};
+
+#define TUNER_SPACING_KHZ(spacing)  (25 << (spacing))
+
+// Default band and channel spacing.
+#ifndef TUNER_BAND
+#define TUNER_BAND          bdWorld
+#endif
+
+#ifndef TUNER_SPACING
+#define TUNER_SPACING       sp25kHz
+#endif
+
+// Frequency range of a band (in 100kHz units).
+typedef struct TunerBandRange
+{
+    unsigned short minFreq;
+    unsigned short maxFreq;
+} TunerBandRange;
+
+extern const TunerBandRange tunerBands[bdCount];
+
+// Call rate of receiverTick.
+#ifndef RECEIVER_TICKS_PER_SEC
+#define RECEIVER_TICKS_PER_SEC  195
+#endif
+
+// Interval (in ms) of the RDS group reads while waiting for the PI code.
+#define RDS_PI_POLL_TIME    20
+
+#ifdef TUNER_INT
+
+#ifdef TUNER_SIM
+#error "TUNER_INT requires a receiver with an interrupt output (TUNER_RDA5807M)"
+#endif
+
+// MCU input connected to the interrupt output of the tuner (GPIO2 of
+// RDA5807M). Default is PC6, which replaces the preset channel indicator
+// output. Backend configures the input and handles the interrupt.
+#ifndef TUNER_INT_PIN
+#define TUNER_INT_PIN           0x40
+#define TUNER_INT_DDR           PC_DDR
+#define TUNER_INT_CR1           PC_CR1
+#define TUNER_INT_CR2           PC_CR2
+#define TUNER_INT_IRQ           PORTC_IRQ
+#define TUNER_INT_SENSE_MASK    0x30    // EXTI_CR1 : PCIS
+#define TUNER_INT_SENSE_FALL    0x20    // Falling edge only.
+#endif
+
+void TUNER_interrupt() __interrupt(TUNER_INT_IRQ);
+
+#endif
+
+unsigned char initTuner(unsigned char volLvl, unsigned short channel);
+unsigned char checkTuner();
+void setTunerVolume(unsigned char volLvl);
+void setTunerFrequency(unsigned short channel);
+void seekChannel(unsigned char isSeekUp);
+
+// Blocking read of the channel, seek/tune and signal status, and the status
+// polling of the main loop (completed in the background).
+void tunerRefreshStatus();
+unsigned char tunerPollStatus();
+void receiverTick();
+
+unsigned char getTuneState();
+void clearTuneState();
+unsigned char waitReceiverTune(unsigned char timeout);
+unsigned char seekStation(unsigned char isSeekUp);
+
+#ifdef RDA_RDS
+unsigned char waitStationPI(unsigned short *pi, unsigned char timeout);
+#endif
+
+void getTunerChannel(unsigned short *channel);
+void setTunerBand(unsigned char band, unsigned char spacing);
+unsigned char getTunerBand();
+unsigned char getTunerSpacing();
+unsigned short getTunerChannelLimit();
+
+unsigned char isStereoChannel();
+unsigned char isStation();
+unsigned char getRSSI();
+unsigned char isSeekFailed();
+unsigned char isTuneComplete();
+
+// Common functions (tuner.c).
+void getTunerFrequency(unsigned char *freq);
+unsigned short getMaxTunerChannel();
+unsigned short getFrequencyChannel(unsigned short freq);
+unsigned char isTunerBandSupported(unsigned char band, unsigned char spacing);
+
+#endif /* FM_MICRO_TUNER_HEADER */
\ No newline at end of file
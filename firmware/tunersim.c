@@ -0,0 +1,309 @@
+//-----------------------------------------------------------------------------
+// Micro FM radio module firmware for STM8S003F3P6.
+// Simulated tuner backend source file.
+//
+// Copyright (C) 2020 SriKIT contributors.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Last updated: SriKIT contributors [19th Oct 2026]
+//
+// Update log:
+// [18/10/2026] - Initial version - SriKIT contributors.
+// [19/10/2026] - Limit the channel range to 10 bits - SriKIT contributors.
+//-----------------------------------------------------------------------------
+
+#include "include/stm8-util.h"
+#include "tuner.h"
+
+// Simulated backend runs the firmware without a receiver chip: a fixed set
+// of stations in the band, seek/tune completing after SIM_TUNE_TICKS and no
+// RDS data.
+
+// Seek/tune time (in receiverTick periods) and the signal level of the
+// channels without a station.
+#define SIM_TUNE_TICKS      10
+#define SIM_NOISE_RSSI      8
+
+// Minimum signal level of the stations received in stereo.
+#define SIM_STEREO_RSSI     32
+
+#define SIM_NO_STATION      0xFF
+
+// Channel range of the simulated receiver, same as RDA5807M (the settings
+// journal and the frequency display cache keep 10 channel bits).
+#define SIM_MAX_CHANNEL     0x3FF
+
+// Simulated station (frequency in 100kHz units and signal level).
+typedef struct SimStation
+{
+    unsigned short freq;
+    unsigned char rssi;
+} SimStation;
+
+const SimStation simStations[] = {
+    {689, 30},      // 68.9MHz
+    {881, 52},      // 88.1MHz
+    {914, 38},      // 91.4MHz
+    {955, 21},      // 95.5MHz
+    {1003, 61},     // 100.3MHz
+    {1047, 27}      // 104.7MHz
+    };
+
+#define SIM_STATION_COUNT   (sizeof(simStations) / sizeof(SimStation))
+
+unsigned short simChannel = 0;
+unsigned char simBand = TUNER_BAND;
+unsigned char simSpacing = TUNER_SPACING;
+unsigned char simStation = SIM_NO_STATION;
+unsigned char simSeekFailed = 0;
+
+// Seek/tune progress (TuneState) and the remaining seek/tune time.
+volatile unsigned char simTuneState = tnIdle;
+volatile unsigned char simTuneTicks = 0;
+
+static unsigned char findStation(unsigned short channel)
+{
+    unsigned char pos = 0;
+
+    while(pos < SIM_STATION_COUNT)
+    {
+        if(getFrequencyChannel(simStations[pos].freq) == channel)
+        {
+            return pos;
+        }
+
+        pos++;
+    }
+
+    return SIM_NO_STATION;
+}
+
+static void startTune(unsigned short channel)
+{
+    simChannel = channel;
+    simStation = findStation(channel);
+
+    __critical
+    {
+        simTuneTicks = SIM_TUNE_TICKS;
+        simTuneState = tnBusy;
+    }
+}
+
+static unsigned char updateTuneState()
+{
+    // Seek/tune completes once its time is elapsed.
+    if((simTuneState == tnBusy) && (simTuneTicks == 0))
+    {
+        simTuneState = simSeekFailed ? tnFailed : tnDone;
+        return 1;
+    }
+
+    return 0;
+}
+
+unsigned char initTuner(unsigned char volLvl, unsigned short channel)
+{
+    setTunerVolume(volLvl);
+    setTunerFrequency(channel);
+    return tfNone;
+}
+
+unsigned char checkTuner()
+{
+    return tfNone;
+}
+
+void setTunerVolume(unsigned char volLvl)
+{
+    // There is no audio output to control.
+}
+
+void setTunerFrequency(unsigned short channel)
+{
+    simSeekFailed = 0;
+    startTune(channel);
+}
+
+void seekChannel(unsigned char isSeekUp)
+{
+    unsigned short maxChannel = getMaxTunerChannel();
+    unsigned short channel;
+    unsigned short next = 0xFFFF;
+    unsigned short wrap = 0xFFFF;
+    unsigned char pos = 0;
+
+    // Find the closest station in the seek direction, or wrap around the band.
+    while(pos < SIM_STATION_COUNT)
+    {
+        channel = getFrequencyChannel(simStations[pos].freq);
+        if(channel <= maxChannel)
+        {
+            if(isSeekUp)
+            {
+                if((channel > simChannel) && ((next == 0xFFFF) || (channel < next)))
+                {
+                    next = channel;
+                }
+
+                if((wrap == 0xFFFF) || (channel < wrap))
+                {
+                    wrap = channel;
+                }
+            }
+            else
+            {
+                if((channel < simChannel) && ((next == 0xFFFF) || (channel > next)))
+                {
+                    next = channel;
+                }
+
+                if((wrap == 0xFFFF) || (channel > wrap))
+                {
+                    wrap = channel;
+                }
+            }
+        }
+
+        pos++;
+    }
+
+    if(next == 0xFFFF)
+    {
+        next = wrap;
+    }
+
+    // Seek fails if there are no stations in the band.
+    simSeekFailed = (next == 0xFFFF);
+    startTune(simSeekFailed ? simChannel : next);
+}
+
+void tunerRefreshStatus()
+{
+    updateTuneState();
+}
+
+unsigned char tunerPollStatus()
+{
+    return updateTuneState();
+}
+
+void receiverTick()
+{
+    if(simTuneTicks)
+    {
+        simTuneTicks--;
+    }
+}
+
+unsigned char getTuneState()
+{
+    return simTuneState;
+}
+
+void clearTuneState()
+{
+    // Acknowledge the result of the last seek/tune.
+    if(simTuneState != tnBusy)
+    {
+        simTuneState = tnIdle;
+    }
+}
+
+unsigned char waitReceiverTune(unsigned char timeout)
+{
+    while(timeout && (!updateTuneState()) && (simTuneState == tnBusy))
+    {
+        delay_ms(1);
+        timeout--;
+    }
+
+    return (simTuneState != tnBusy);
+}
+
+unsigned char seekStation(unsigned char isSeekUp)
+{
+    unsigned char isFound;
+
+    // Start the seek and wait until it completes.
+    seekChannel(isSeekUp);
+    waitReceiverTune(0xFF);
+
+    // Result is consumed here, so it is not reported as a failed user seek.
+    isFound = (simTuneState == tnDone);
+    clearTuneState();
+    return isFound;
+}
+
+#ifdef RDA_RDS
+
+unsigned char waitStationPI(unsigned short *pi, unsigned char timeout)
+{
+    // Simulated stations do not broadcast RDS.
+    return 0;
+}
+
+#endif
+
+void getTunerChannel(unsigned short *channel)
+{
+    (*channel) = simChannel;
+}
+
+void setTunerBand(unsigned char band, unsigned char spacing)
+{
+    simBand = band;
+    simSpacing = spacing;
+}
+
+unsigned char getTunerBand()
+{
+    return simBand;
+}
+
+unsigned char getTunerSpacing()
+{
+    return simSpacing;
+}
+
+unsigned short getTunerChannelLimit()
+{
+    return SIM_MAX_CHANNEL;
+}
+
+unsigned char isStereoChannel()
+{
+    return (isStation() && (simStations[simStation].rssi >= SIM_STEREO_RSSI));
+}
+
+unsigned char isStation()
+{
+    return ((simTuneState != tnBusy) && (simStation != SIM_NO_STATION));
+}
+
+unsigned char getRSSI()
+{
+    return isStation() ? simStations[simStation].rssi : SIM_NOISE_RSSI;
+}
+
+unsigned char isSeekFailed()
+{
+    return simSeekFailed;
+}
+
+unsigned char isTuneComplete()
+{
+    return (simTuneState != tnBusy);
+}
\ No newline at end of file
@@ -20,21 +20,230 @@
 //
 // Update log:
 // [24/10/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Add word programming - SriKIT contributors.
+// [18/10/2026] - Add interrupt driven write queue - SriKIT contributors.
+// [18/10/2026] - Add block writes - SriKIT contributors.
+// [18/10/2026] - Restore the interrupt state of the caller after the waits - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #include "../include/stm8-eeprom.h"
 
+// Pending writes, the head entry is being programmed.
+EEPROMWrite eepromQueue[EEPROM_QUEUE_SIZE];
+volatile unsigned char eepromQueueHead = 0;
+volatile unsigned char eepromQueueCount = 0;
+
+// Condition code register of the caller, to restore its interrupt mask after
+// the waits.
+unsigned char eepromSavedCC;
+
+static void eepromBeginWrite()
+{
+    EEPROMWrite *entry = &eepromQueue[eepromQueueHead];
+    unsigned char pos = 0;
+
+    // Unlock EEPROM (stays unlocked until the queue is empty).
+    if(!(FLASH_IAPSR & FLASH_IAPSR_DUL))
+    {
+        FLASH_DUKR = FLASH_DUKR_KEY1;
+        FLASH_DUKR = FLASH_DUKR_KEY2;
+        while (!(FLASH_IAPSR & FLASH_IAPSR_DUL));
+    }
+
+    if(entry->length == EEPROM_WORD_SIZE)
+    {
+        // Enable word programming (cleared by the hardware at the end of
+        // operation), all 4 bytes of the word are programmed in a single cycle.
+        FLASH_CR2 |= FLASH_CR2_WPRG;
+        FLASH_NCR2 &= ~(FLASH_NCR2_NWPRG);
+    }
+
+    // Programming starts after the last byte, end of operation raises FLASH_IRQ.
+    FLASH_CR1 |= FLASH_CR1_IE;
+    while(pos < entry->length)
+    {
+        GLOBAL_MEM(entry->addr + pos) = entry->data[pos];
+        pos++;
+    }
+}
+
+static void eepromSubmit(unsigned short addr, const unsigned char *value, unsigned char length)
+{
+    EEPROMWrite *entry;
+    unsigned char pos = 0;
+
+    if(eepromQueueCount >= EEPROM_QUEUE_SIZE)
+    {
+        // Wait (in WFI) for a free entry, WFI re-enables interrupts atomically.
+        saveInterruptState(eepromSavedCC);
+        while(1)
+        {
+            cli();
+            if(eepromQueueCount < EEPROM_QUEUE_SIZE)
+            {
+                break;
+            }
+
+            wfi();
+        }
+
+        restoreInterruptState(eepromSavedCC);
+    }
+
+    // Queue is also modified by the end of operation interrupt.
+    __critical
+    {
+        entry = &eepromQueue[(eepromQueueHead + eepromQueueCount) & (EEPROM_QUEUE_SIZE - 1)];
+        entry->addr = addr;
+        entry->length = length;
+        while(pos < length)
+        {
+            entry->data[pos] = value[pos];
+            pos++;
+        }
+
+        if((++eepromQueueCount) == 1)
+        {
+            // EEPROM is idle, start the write immediately.
+            eepromBeginWrite();
+        }
+    }
+}
+
 void eepromWrite(unsigned short addr, unsigned char value)
 {
-    // Unlock EEPROM.
-    FLASH_DUKR = FLASH_DUKR_KEY1;
-    FLASH_DUKR = FLASH_DUKR_KEY2;
-    while (!(FLASH_IAPSR & FLASH_IAPSR_DUL));
+    eepromSubmit(addr, &value, 1);
+}
+
+void eepromWriteWord(unsigned short addr, const unsigned char *value)
+{
+    eepromSubmit(addr, value, EEPROM_WORD_SIZE);
+}
+
+unsigned char eepromRead(unsigned short addr)
+{
+    EEPROMWrite *entry;
+    unsigned char pos;
+    unsigned char value;
+
+    __critical
+    {
+        value = GLOBAL_MEM(addr);
+
+        // Newest pending write of the address overrides the EEPROM content.
+        pos = eepromQueueCount;
+        while(pos > 0)
+        {
+            pos--;
+            entry = &eepromQueue[(eepromQueueHead + pos) & (EEPROM_QUEUE_SIZE - 1)];
+            if((addr >= entry->addr) && (addr < (entry->addr + entry->length)))
+            {
+                value = entry->data[addr - entry->addr];
+                break;
+            }
+        }
+    }
+
+    return value;
+}
+
+void eepromFlush()
+{
+    // Wait (in WFI) until all the pending writes are programmed.
+    saveInterruptState(eepromSavedCC);
+    while(1)
+    {
+        cli();
+        if(eepromQueueCount == 0)
+        {
+            break;
+        }
+
+        wfi();
+    }
+
+    restoreInterruptState(eepromSavedCC);
+}
+
+void eepromWriteShort(unsigned short addr, unsigned short value)
+{
+    unsigned char word[EEPROM_WORD_SIZE];
+    unsigned short wordAddr = addr & ~(EEPROM_WORD_SIZE - 1);
+    unsigned char pos = addr & (EEPROM_WORD_SIZE - 1);
+
+    if(pos == (EEPROM_WORD_SIZE - 1))
+    {
+        // Value crosses the word boundary, write it byte by byte.
+        eepromWrite(addr, ((value >> 8) & 0xFF));
+        eepromWrite((addr + 1), (value & 0xFF));
+        return;
+    }
+
+    // Keep the other bytes of the word and replace the value (most significant
+    // byte first).
+    word[0] = eepromRead(wordAddr);
+    word[1] = eepromRead(wordAddr + 1);
+    word[2] = eepromRead(wordAddr + 2);
+    word[3] = eepromRead(wordAddr + 3);
 
-    // Writing data into specified address.
-    GLOBAL_MEM(addr) = value;
-    while (!(FLASH_IAPSR & FLASH_IAPSR_EOP));
+    word[pos] = (value >> 8) & 0xFF;
+    word[pos + 1] = value & 0xFF;
+
+    eepromWriteWord(wordAddr, word);
+}
+
+void eepromWriteBlock(unsigned short addr, const unsigned char *value, unsigned char length)
+{
+    unsigned char word[EEPROM_WORD_SIZE];
+    unsigned short wordAddr = addr & ~(EEPROM_WORD_SIZE - 1);
+    unsigned short endAddr = addr + length;
+    unsigned char isChanged;
+    unsigned char pos;
+
+    // Program each word of the block once, and only if its content is changed.
+    while(wordAddr < endAddr)
+    {
+        isChanged = 0;
+        pos = 0;
+        while(pos < EEPROM_WORD_SIZE)
+        {
+            // Bytes outside of the block keep their current value.
+            word[pos] = eepromRead(wordAddr + pos);
+            if(((wordAddr + pos) >= addr) && ((wordAddr + pos) < endAddr) && (word[pos] != value[wordAddr + pos - addr]))
+            {
+                word[pos] = value[wordAddr + pos - addr];
+                isChanged = 1;
+            }
+
+            pos++;
+        }
+
+        if(isChanged)
+        {
+            eepromWriteWord(wordAddr, word);
+        }
+
+        wordAddr += EEPROM_WORD_SIZE;
+    }
+}
+
+void FLASH_event() __interrupt(FLASH_IRQ)
+{
+    // Reading IAPSR clears EOP (and WR_PG_DIS of a rejected write).
+    if(FLASH_IAPSR & (FLASH_IAPSR_EOP | FLASH_IAPSR_WR_PG_DIS))
+    {
+        eepromQueueHead = (eepromQueueHead + 1) & (EEPROM_QUEUE_SIZE - 1);
+        eepromQueueCount--;
 
-    // Lock EEPROM.
-    FLASH_IAPSR &= ~(FLASH_IAPSR_DUL);
+        if(eepromQueueCount)
+        {
+            eepromBeginWrite();
+        }
+        else
+        {
+            // Queue is empty, disable the interrupt and lock EEPROM.
+            FLASH_CR1 &= ~(FLASH_CR1_IE);
+            FLASH_IAPSR &= ~(FLASH_IAPSR_DUL);
+        }
+    }
 }
\ No newline at end of file
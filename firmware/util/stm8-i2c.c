@@ -1,5 +1,5 @@
 //-----------------------------------------------------------------------------
-// STM8S I2C library for standard mode communication.
+// STM8S I2C library for standard and fast mode communication.
 //
 // Copyright (C) 2020 SriKIT contributors.
 //
@@ -20,62 +20,641 @@
 //
 // Update log:
 // [09/10/2020] - Initial version - Dilshan Jayakody.
+// [18/10/2026] - Add interrupt driven transaction queue - SriKIT contributors.
+// [18/10/2026] - Add fast mode and computed bus timing - SriKIT contributors.
+// [18/10/2026] - Add timeouts, bus recovery and error counters - SriKIT contributors.
+// [18/10/2026] - Add write then read (repeated start) transactions - SriKIT contributors.
+// [19/10/2026] - Restore the interrupt state of the caller after the wait - SriKIT contributors.
 //-----------------------------------------------------------------------------
 
 #include "../include/stm8-i2c.h"
+#include "../include/stm8-util.h"
 
 #ifndef F_CPU
 #warning "F_CPU not defined, using 2MHz as default CPU clock frequency"
 #define F_CPU 2000000UL
 #endif
 
+// I2C peripheral is clocked from the master clock (fMASTER), which may run
+// faster than the CPU clock when CPUDIV is in use.
+#ifndef F_MASTER
+#define F_MASTER F_CPU
+#endif
+
+#ifndef I2C_SPEED
+#warning "I2C_SPEED not defined, using 100kHz standard mode"
+#define I2C_SPEED 100000UL
+#endif
+
+#define I2C_FREQ_MHZ    (F_MASTER / 1000000UL)
+
+#if (I2C_FREQ_MHZ < 1) || (I2C_FREQ_MHZ > 24)
+#error "I2C peripheral clock must be between 1MHz and 24MHz"
+#endif
+
+#if (I2C_SPEED <= 100000UL)
+
+// Standard mode: Thigh = Tlow = CCR * Tmaster, maximum SCL rise time is 1000ns.
+#define I2C_CCR         ((F_MASTER + (2 * I2C_SPEED) - 1) / (2 * I2C_SPEED))
+#define I2C_CCRH_MODE   0x00
+#define I2C_TRISE       (I2C_FREQ_MHZ + 1)
+
+#if (I2C_CCR < 4)
+#error "I2C standard mode speed is too high for the peripheral clock"
+#endif
+
+#elif (I2C_SPEED <= 400000UL)
+
+#if (I2C_FREQ_MHZ < 4)
+#error "I2C fast mode requires peripheral clock of 4MHz or higher"
+#endif
+
+// Fast mode: DUTY = 0 gives Tlow/Thigh = 2, DUTY = 1 gives Tlow/Thigh = 16/9.
+#define I2C_CCR_DUTY0   ((F_MASTER + (3 * I2C_SPEED) - 1) / (3 * I2C_SPEED))
+#define I2C_CCR_DUTY1   ((F_MASTER + (25 * I2C_SPEED) - 1) / (25 * I2C_SPEED))
+
+// Select duty cycle which gives the highest bus speed without exceeding the target.
+#if ((25 * I2C_CCR_DUTY1) < (3 * I2C_CCR_DUTY0))
+#define I2C_CCR         I2C_CCR_DUTY1
+#define I2C_CCRH_MODE   (I2C_CCRH_FS | I2C_CCRH_DUTY)
+#else
+#define I2C_CCR         I2C_CCR_DUTY0
+#define I2C_CCRH_MODE   I2C_CCRH_FS
+
+#if (I2C_CCR_DUTY0 < 4)
+#error "I2C fast mode speed is too high for the peripheral clock"
+#endif
+#endif
+
+// Maximum SCL rise time in fast mode is 300ns.
+#define I2C_TRISE       (((I2C_FREQ_MHZ * 3) / 10) + 1)
+
+#else
+#error "I2C_SPEED above 400kHz is not supported"
+#endif
+
+#if (I2C_CCR > 0x0FFF)
+#error "I2C speed is too low for the peripheral clock"
+#endif
+
+// I2C pins in port B (used for bus recovery).
+#define I2C_SCL_PIN     0x10
+#define I2C_SDA_PIN     0x20
+
+// Transaction queue and state of the active (head) transaction.
+static I2CTransaction *i2cQueue[I2C_QUEUE_SIZE];
+static volatile unsigned char i2cQueueHead = 0;
+static volatile unsigned char i2cQueueCount = 0;
+static unsigned char i2cAddress;
+static unsigned char *i2cData;
+static unsigned char i2cRemaining;
+static unsigned char i2cITRShadow = 0;
+static unsigned char i2cActiveTicks;
+
+// Condition code register of the caller, to restore its interrupt mask after
+// the transaction wait.
+unsigned char i2cSavedCC;
+
+// Error statistics.
+unsigned short i2cErrorCount[I2C_ERROR_TYPES];
+unsigned short i2cRecoveryCount = 0;
+
+#ifdef I2C_METER
+// TIM1 prescaler for 1us time base.
+#define I2C_METER_PRESCALER ((F_MASTER / 1000000UL) - 1)
+
+// Cumulative counters and double buffered window counters.
+I2CMeter i2cMeterTotal;
+I2CMeter i2cMeterWindow[2];
+static unsigned char i2cMeterSlot = 0;
+static unsigned char i2cMeterTicks = 0;
+static unsigned short i2cMeterStart;
+
+static unsigned short i2cMeterTime()
+{
+    unsigned short timeValue;
+
+    // Reading MSB first latches the LSB of the counter.
+    timeValue = ((unsigned short)TIM1_CNTRH) << 8;
+    return timeValue | TIM1_CNTRL;
+}
+
+static void i2cMeterInit()
+{
+    // Free running TIM1 with 1us resolution (kept running across bus recovery).
+    if(TIM1_CR1 & TIM1_CR1_CEN)
+    {
+        return;
+    }
+
+    TIM1_PSCRH = (I2C_METER_PRESCALER >> 8) & 0xFF;
+    TIM1_PSCRL = I2C_METER_PRESCALER & 0xFF;
+    TIM1_ARRH = 0xFF;
+    TIM1_ARRL = 0xFF;
+    TIM1_EGR = TIM1_EGR_UG;
+    TIM1_CR1 = TIM1_CR1_CEN;
+}
+
+static void i2cMeterUpdate(I2CTransaction *trans, unsigned char error)
+{
+    I2CMeter *window = &i2cMeterWindow[i2cMeterSlot];
+    unsigned short elapsed = i2cMeterTime() - i2cMeterStart;
+    unsigned char bytes = 0;
+
+    if(error == I2C_ERR_NONE)
+    {
+        bytes = trans->length + trans->readLength;
+    }
+    else if(error == I2C_ERR_NACK)
+    {
+        i2cMeterTotal.nacks++;
+        window->nacks++;
+    }
+
+    i2cMeterTotal.transactions++;
+    i2cMeterTotal.bytes += bytes;
+    i2cMeterTotal.busyTime += elapsed;
+
+    window->transactions++;
+    window->bytes += bytes;
+    window->busyTime += elapsed;
+}
+
+static void i2cMeterTick()
+{
+    I2CMeter *window;
+
+    if((++i2cMeterTicks) < I2C_METER_WINDOW)
+    {
+        return;
+    }
+
+    // Publish the current window and start a new one.
+    i2cMeterTicks = 0;
+    i2cMeterSlot ^= 1;
+
+    window = &i2cMeterWindow[i2cMeterSlot];
+    window->transactions = 0;
+    window->bytes = 0;
+    window->nacks = 0;
+    window->busyTime = 0;
+}
+
+I2CMeter *i2cGetMeterTotal()
+{
+    return &i2cMeterTotal;
+}
+
+I2CMeter *i2cGetMeterWindow()
+{
+    return &i2cMeterWindow[i2cMeterSlot ^ 1];
+}
+#endif
+
 inline void i2cInit()
 {
-    // CPU clocking frequency.
-    I2C_FREQR = F_CPU / 1000000; 
+    // Peripheral clocking frequency.
+    I2C_FREQR = I2C_FREQ_MHZ;
 
-    // I2C frequency. Default (0x000A) is set to 100kHz.
-    I2C_CCRH = 0x00;
-    I2C_CCRL = 0x0A;
+    // I2C bus speed, duty cycle and rise time derived from I2C_SPEED.
+    I2C_CCRH = I2C_CCRH_MODE | ((I2C_CCR >> 8) & I2C_CCRH_CCR);
+    I2C_CCRL = I2C_CCR & 0xFF;
+    I2C_TRISER = I2C_TRISE;
 
     // 7-bit addressing mode.
     I2C_OARH = I2C_OARH_ADDMODE;
 
     // Enable I2C.
     I2C_CR1 = I2C_CR1_PE;
+
+#ifdef I2C_METER
+    i2cMeterInit();
+#endif
+}
+
+static unsigned char i2cPollFlag(volatile unsigned char *reg, unsigned char mask, unsigned char value)
+{
+    unsigned short limit = I2C_POLL_LIMIT;
+
+    // Wait for the flag with bounded number of polls.
+    while(((*reg) & mask) != value)
+    {
+        if((--limit) == 0)
+        {
+            i2cErrorCount[I2C_ERR_TIMEOUT]++;
+            i2cRecoverBus();
+            return I2C_ERR_TIMEOUT;
+        }
+    }
+
+    return I2C_ERR_NONE;
+}
+
+void i2cRecoverBus()
+{
+    unsigned char pulse = 9;
+
+    i2cRecoveryCount++;
+
+    // Disconnect the peripheral and drive the bus pins as open-drain outputs.
+    I2C_CR1 = 0;
+    PB_ODR |= (I2C_SCL_PIN | I2C_SDA_PIN);
+    PB_DDR |= (I2C_SCL_PIN | I2C_SDA_PIN);
+
+    // Clock out up to 9 bits to release a slave which holds SDA low.
+    while(pulse)
+    {
+        PB_ODR &= ~(I2C_SCL_PIN);
+        delay_cycle(3);
+        PB_ODR |= I2C_SCL_PIN;
+        delay_cycle(3);
+        pulse--;
+    }
+
+    // Generate stop condition (SDA rising while SCL is high).
+    PB_ODR &= ~(I2C_SCL_PIN);
+    PB_ODR &= ~(I2C_SDA_PIN);
+    delay_cycle(3);
+    PB_ODR |= I2C_SCL_PIN;
+    delay_cycle(3);
+    PB_ODR |= I2C_SDA_PIN;
+    delay_cycle(3);
+
+    // Return the pins to the peripheral, reset and reinitialize it.
+    PB_DDR &= ~(I2C_SCL_PIN | I2C_SDA_PIN);
+    I2C_CR2 = I2C_CR2_SWRST;
+    I2C_CR2 = 0;
+    i2cITRShadow = 0;
+    i2cInit();
 }
 
-void i2cStart()
+unsigned short i2cGetErrorCount(unsigned char errorType)
+{
+    return i2cErrorCount[errorType];
+}
+
+unsigned short i2cGetRecoveryCount()
+{
+    return i2cRecoveryCount;
+}
+
+unsigned char i2cStart()
 {
     I2C_CR2 |= I2C_CR2_START;
-    while (!(I2C_SR1 & I2C_SR1_SB));
+    return i2cPollFlag(&I2C_SR1, I2C_SR1_SB, I2C_SR1_SB);
 }
 
-void i2cStop()
+unsigned char i2cStop()
 {
     I2C_CR2 |= I2C_CR2_STOP;
-    while (I2C_SR3 & I2C_SR3_MSL);
+    return i2cPollFlag(&I2C_SR3, I2C_SR3_MSL, 0);
 }
 
-void i2cWriteAddr(unsigned char addr)
+unsigned char i2cWriteAddr(unsigned char addr)
 {
+    unsigned short limit = I2C_POLL_LIMIT;
+
     I2C_DR = addr;
-    while (!(I2C_SR1 & I2C_SR1_ADDR));
+    while (!(I2C_SR1 & I2C_SR1_ADDR))
+    {
+        if(I2C_SR2 & I2C_SR2_AF)
+        {
+            // Slave is not responding to the address.
+            I2C_SR2 = 0;
+            I2C_CR2 |= I2C_CR2_STOP;
+            i2cErrorCount[I2C_ERR_NACK]++;
+            return I2C_ERR_NACK;
+        }
+
+        if((--limit) == 0)
+        {
+            i2cErrorCount[I2C_ERR_TIMEOUT]++;
+            i2cRecoverBus();
+            return I2C_ERR_TIMEOUT;
+        }
+    }
 
     (void) I2C_SR3;
     I2C_CR2 |= I2C_CR2_ACK;
+
+    return I2C_ERR_NONE;
 }
 
-void i2cWrite(unsigned char data)
+unsigned char i2cWrite(unsigned char data)
 {
     I2C_DR = data;
-    while (!(I2C_SR1 & I2C_SR1_TXE));
+    return i2cPollFlag(&I2C_SR1, I2C_SR1_TXE, I2C_SR1_TXE);
 }
 
 unsigned char i2cRead(unsigned char ack)
 {
     I2C_CR2 = (ack) ? (I2C_CR2 | I2C_CR2_ACK) : (I2C_CR2 & (~(I2C_CR2_ACK)));
-    while (!(I2C_SR1 & (I2C_SR1_RXNE)));
+    if(i2cPollFlag(&I2C_SR1, I2C_SR1_RXNE, I2C_SR1_RXNE) != I2C_ERR_NONE)
+    {
+        return 0xFF;
+    }
 
     return I2C_DR;
+}
+
+static void i2cEndTransaction(unsigned char error);
+
+static void i2cBeginPhase(unsigned char address, unsigned char *buffer, unsigned char length)
+{
+    i2cAddress = address;
+    i2cData = buffer;
+    i2cRemaining = length;
+
+    // Two byte reception uses POS to NACK the second byte (RM0016 method 2).
+    if((address & I2C_READ_FLAG) && (length == 2))
+    {
+        I2C_CR2 |= (I2C_CR2_POS | I2C_CR2_ACK);
+    }
+
+    // Generate (repeated) start condition and let the interrupt handler do the rest.
+    i2cITRShadow = I2C_ITR_ITEVTEN | I2C_ITR_ITBUFEN | I2C_ITR_ITERREN;
+    I2C_ITR = i2cITRShadow;
+    I2C_CR2 |= I2C_CR2_START;
+}
+
+static void i2cBeginTransaction()
+{
+    I2CTransaction *trans = i2cQueue[i2cQueueHead];
+
+    trans->state = tsActive;
+    trans->error = I2C_ERR_NONE;
+    i2cActiveTicks = 0;
+
+#ifdef I2C_METER
+    i2cMeterStart = i2cMeterTime();
+#endif
+
+    i2cBeginPhase(trans->address, trans->buffer, trans->length);
+}
+
+static void i2cEndWritePhase(I2CTransaction *trans)
+{
+    if(trans->readLength)
+    {
+        // Continue with the read phase after a repeated start.
+        i2cBeginPhase((trans->readAddress | I2C_READ_FLAG), trans->readBuffer, trans->readLength);
+    }
+    else
+    {
+        I2C_CR2 |= I2C_CR2_STOP;
+        i2cEndTransaction(I2C_ERR_NONE);
+    }
+}
+
+static void i2cEndTransaction(unsigned char error)
+{
+    I2CTransaction *trans = i2cQueue[i2cQueueHead];
+    unsigned short limit = I2C_POLL_LIMIT;
+
+    i2cITRShadow = 0;
+    I2C_ITR = 0;
+    I2C_CR2 &= ~(I2C_CR2_POS);
+
+    // Wait until the stop condition is released into the bus.
+    while (I2C_CR2 & I2C_CR2_STOP)
+    {
+        if((--limit) == 0)
+        {
+            error = I2C_ERR_TIMEOUT;
+            break;
+        }
+    }
+
+#ifdef I2C_METER
+    i2cMeterUpdate(trans, error);
+#endif
+
+    if(error != I2C_ERR_NONE)
+    {
+        i2cErrorCount[error]++;
+
+        // NACK leaves the bus in a valid state, any other fault needs recovery.
+        if(error != I2C_ERR_NACK)
+        {
+            i2cRecoverBus();
+        }
+    }
+
+    // Remove transaction from the queue and notify the owner.
+    i2cQueueHead = (i2cQueueHead + 1) & (I2C_QUEUE_SIZE - 1);
+    i2cQueueCount--;
+
+    trans->error = error;
+    trans->state = (error == I2C_ERR_NONE) ? tsDone : tsError;
+    if(trans->callback)
+    {
+        trans->callback(trans);
+    }
+
+    // Continue with the next queued transaction (unless the callback has
+    // already started a newly submitted one).
+    if(i2cQueueCount && (i2cITRShadow == 0))
+    {
+        i2cBeginTransaction();
+    }
+}
+
+unsigned char i2cSubmit(I2CTransaction *trans)
+{
+    unsigned char isQueued = 0;
+
+    // Queue is also modified by the I2C and timer (timeout) interrupts.
+    __critical
+    {
+        if(i2cQueueCount < I2C_QUEUE_SIZE)
+        {
+            trans->state = tsQueued;
+            i2cQueue[(i2cQueueHead + i2cQueueCount) & (I2C_QUEUE_SIZE - 1)] = trans;
+            i2cQueueCount++;
+            isQueued = 1;
+
+            if(i2cQueueCount == 1)
+            {
+                // Bus is idle, start the transaction immediately.
+                i2cBeginTransaction();
+            }
+        }
+    }
+
+    return isQueued;
+}
+
+void i2cWait(I2CTransaction *trans)
+{
+    // WFI re-enables interrupts atomically, so a completion interrupt raised
+    // after the state check still wakes up the CPU. The transaction timeout
+    // (i2cTick) guarantees this loop terminates.
+    saveInterruptState(i2cSavedCC);
+    while(1)
+    {
+        cli();
+        if(!i2cIsPending(trans))
+        {
+            break;
+        }
+
+        wfi();
+    }
+
+    restoreInterruptState(i2cSavedCC);
+}
+
+void i2cTick()
+{
+    // Abort the active transaction if it does not complete in time.
+    if(i2cITRShadow && ((++i2cActiveTicks) > I2C_TIMEOUT_TICKS))
+    {
+        i2cEndTransaction(I2C_ERR_TIMEOUT);
+    }
+
+#ifdef I2C_METER
+    i2cMeterTick();
+#endif
+}
+
+void I2C_event() __interrupt(IIC_IRQ)
+{
+    I2CTransaction *trans = i2cQueue[i2cQueueHead];
+    unsigned char status;
+
+    // Abort the transaction on NACK, bus error, arbitration lost or overrun.
+    status = I2C_SR2;
+    if(status & (I2C_SR2_AF | I2C_SR2_ARLO | I2C_SR2_BERR | I2C_SR2_OVR))
+    {
+        I2C_SR2 = 0;
+
+        if(status & I2C_SR2_AF)
+        {
+            I2C_CR2 |= I2C_CR2_STOP;
+            i2cEndTransaction(I2C_ERR_NACK);
+        }
+        else
+        {
+            i2cEndTransaction((status & I2C_SR2_BERR) ? I2C_ERR_BUS : ((status & I2C_SR2_ARLO) ? I2C_ERR_ARBITRATION : I2C_ERR_OVERRUN));
+        }
+
+        return;
+    }
+
+    status = I2C_SR1;
+
+    if(status & I2C_SR1_SB)
+    {
+        // Start condition is generated, send the slave address.
+        I2C_DR = i2cAddress;
+        return;
+    }
+
+    if(status & I2C_SR1_ADDR)
+    {
+        if(i2cAddress & I2C_READ_FLAG)
+        {
+            if(i2cRemaining == 1)
+            {
+                // Single byte reception: NACK and stop after the only byte.
+                I2C_CR2 &= ~(I2C_CR2_ACK);
+                (void) I2C_SR3;
+                I2C_CR2 |= I2C_CR2_STOP;
+            }
+            else
+            {
+                if(i2cRemaining == 2)
+                {
+                    I2C_CR2 &= ~(I2C_CR2_ACK);
+                }
+                else
+                {
+                    I2C_CR2 |= I2C_CR2_ACK;
+                }
+
+                (void) I2C_SR3;
+
+                // Last 2-3 bytes are handled with BTF events.
+                if(i2cRemaining <= 3)
+                {
+                    i2cITRShadow &= ~(I2C_ITR_ITBUFEN);
+                    I2C_ITR = i2cITRShadow;
+                }
+            }
+        }
+        else
+        {
+            (void) I2C_SR3;
+
+            if(i2cRemaining == 0)
+            {
+                // Address only write phase.
+                i2cEndWritePhase(trans);
+            }
+        }
+
+        return;
+    }
+
+    if(i2cAddress & I2C_READ_FLAG)
+    {
+        if(i2cRemaining > 3)
+        {
+            if(status & I2C_SR1_RXNE)
+            {
+                *i2cData++ = I2C_DR;
+
+                if((--i2cRemaining) == 3)
+                {
+                    // Wait for BTF to read the last 3 bytes.
+                    i2cITRShadow &= ~(I2C_ITR_ITBUFEN);
+                    I2C_ITR = i2cITRShadow;
+                }
+            }
+        }
+        else if((status & I2C_SR1_BTF) && (i2cRemaining == 3))
+        {
+            // Byte N-2 in DR, N-1 in shift register: NACK the last byte.
+            I2C_CR2 &= ~(I2C_CR2_ACK);
+            *i2cData++ = I2C_DR;
+            I2C_CR2 |= I2C_CR2_STOP;
+            *i2cData++ = I2C_DR;
+            i2cRemaining = 1;
+
+            i2cITRShadow |= I2C_ITR_ITBUFEN;
+            I2C_ITR = i2cITRShadow;
+        }
+        else if((status & I2C_SR1_BTF) && (i2cRemaining == 2))
+        {
+            I2C_CR2 |= I2C_CR2_STOP;
+            *i2cData++ = I2C_DR;
+            *i2cData++ = I2C_DR;
+            i2cRemaining = 0;
+            i2cEndTransaction(I2C_ERR_NONE);
+        }
+        else if((status & I2C_SR1_RXNE) && (i2cRemaining == 1))
+        {
+            *i2cData++ = I2C_DR;
+            i2cRemaining = 0;
+            i2cEndTransaction(I2C_ERR_NONE);
+        }
+    }
+    else
+    {
+        if(i2cRemaining && (status & I2C_SR1_TXE))
+        {
+            I2C_DR = *i2cData++;
+
+            if((--i2cRemaining) == 0)
+            {
+                // Last byte is loaded, wait for BTF to generate the stop.
+                i2cITRShadow &= ~(I2C_ITR_ITBUFEN);
+                I2C_ITR = i2cITRShadow;
+            }
+        }
+        else if((i2cRemaining == 0) && (status & I2C_SR1_BTF))
+        {
+            i2cEndWritePhase(trans);
+        }
+    }
 }
\ No newline at end of file